@@ -0,0 +1,1481 @@
+/*
+ * ucoro_bench.cpp
+ *
+ * Micro-benchmarks of the three execution models shipped in this repo:
+ *  - task     : ucoro::Task<T, Policy>          (coro/)
+ *  - proto    : Protothread                      (proto/Protothread.h)
+ *  - instant  : InstantCoroutine                 (proto/InstantCoroutine.h)
+ *
+ * Measured:
+ *  - resume        : one suspend/resume round trip of a single instance
+ *  - switch        : round-robin over many instances (context-switch throughput)
+ *  - wake          : event pend() -> waiting instance runs again
+ *  - wake_loaded   : same, while 64 lower-priority tasks keep yielding
+ *                    (FIFO Scheduler vs. PriorityScheduler), avg and max
+ *  - idle_tasks    : 10000 parked tasks, one woken per pass: resume() on
+ *                    every task (polls is_blocked()) vs. Scheduler
+ *                    (ready queue only), ns per pass
+ *  - yield_int     : consume a lazy sequence: Generator<T> (yields the
+ *  - yield_record    address) vs. Task<T> + value() (copies into the
+ *                    promise), for int and a 256-byte record; ns per item
+ *  - footprint     : bytes per instance (coroutine frame vs. object state),
+ *                    for Task also with CompactPolicy error storage and
+ *                    LeanPolicy (no await chain, no ready link)
+ *  - wake_idle     : event post() from another thread -> waiting task runs,
+ *  - idle_cpu        with the host loop busy polling, sleeping a fixed 1 ms
+ *                    or in TicklessLoop; CPU time of the loop thread in %
+ *  - sleep         : 1000 tasks sleeping 50..1049 ticks in a loop, host
+ *                    loop advancing one tick per pass: yield_timeout
+ *                    (resumed every pass) vs. sleep_for on the TimerWheel;
+ *                    CPU ns per tick and resumes per tick
+ *  - dispatch      : 64 protothreads of 8 different types stepped per
+ *                    round: virtual Run() through Protothread* vs.
+ *                    StaticProtothread in a ProtothreadScheduler (tuple)
+ *  - wait_points   : 64 protothreads with 32 wait points each, started at
+ *                    different points: dense __COUNTER__ states (1 byte)
+ *                    vs. the former sparse __LINE__ states (4 bytes),
+ *                    best of 7 runs
+ *  - bulk          : 16384 identical InstantCoroutines, 3 of 4 finishing
+ *                    early: array of objects vs. CoroutineBulk (state
+ *                    array + fields array + running bitmap), ns per
+ *                    instance and pass
+ *  - rle_push      : RLE Decompressor from InstantCoroutine.h, one
+ *                    operator()(c) per input byte vs. one Push(in, n)
+ *  - rle_pull      : RLE expanding generator, one operator()() per output
+ *                    byte vs. Pull(out, 256); ns per decoded byte, both
+ *                    called as from another translation unit
+ *  - mixed         : one pass over a yielding Task, a StaticProtothread and
+ *                    an InstantCoroutine: hand-written loop vs.
+ *                    MixedScheduler (ns per pass)
+ *  - executor      : 1024 AtomicPolicy tasks yielding after a small
+ *                    compute step, WorkStealingExecutor with 1, 2, 4 ...
+ *                    hardware_concurrency() workers; wall ns per step
+ *  - pipe          : loopback pipe, writer and reader task on EpollReactor
+ *                    (Linux), ns per chunk and MB/s for 64 B and 4 KiB chunks
+ *
+ * Output: one JSON object per line (JSON Lines) on stdout, e.g.
+ *  {"bench":"resume","model":"task","policy":"PlainPolicy","iterations":1000000,"ns_per_op":4.1}
+ *
+ * Build (no build system in this repo, header-only):
+ *  g++ -std=c++20 -O2 -DNDEBUG -I coro -I proto bench/ucoro_bench.cpp -o ucoro_bench
+ *  ./ucoro_bench [iterations]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "u_coro.h"
+#include "coro_scheduler.h"
+#include "coro_priority.h"
+#include "coro_event.h"
+#include "coro_idle.h"
+#include "coro_epoll.h"
+#include "coro_mixed.h"
+#include "coro_timer.h"
+#include "coro_executor.h"
+#include "coro_generator.h"
+
+#include "Protothread.h"
+#include "InstantCoroutine.h"
+#include "InstantCoroutineBulk.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t iterations = 1000000;
+constexpr std::size_t switch_instances = 64;
+
+// keeps the optimizer from deleting the measured loops
+volatile std::size_t sink = 0;
+
+template<class F>
+double ns_per_op(std::size_t ops, F&& body) {
+    const auto start = clock_type::now();
+    body();
+    const auto stop = clock_type::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(ops);
+}
+
+void report(const char* bench, const char* model, const char* policy, std::size_t ops, double ns) {
+    std::printf("{\"bench\":\"%s\",\"model\":\"%s\",\"policy\":\"%s\",\"iterations\":%zu,\"ns_per_op\":%.3f}\n",
+                bench, model, policy, ops, ns);
+}
+
+void report_size(const char* model, const char* policy, std::size_t bytes) {
+    std::printf("{\"bench\":\"footprint\",\"model\":\"%s\",\"policy\":\"%s\",\"bytes\":%zu}\n",
+                model, policy, bytes);
+}
+
+/*
+ * *******************************************************************
+ *  Frame size probe: allocator that remembers the last frame size
+ * *******************************************************************
+*/
+struct ProbeAllocator {
+    inline static std::size_t last_size = 0;
+
+    static void* allocate(std::size_t size) noexcept {
+        last_size = size;
+        return ucoro::HeapFrameAllocator::allocate(size);
+    }
+
+    static void deallocate(void* ptr, std::size_t size) noexcept {
+        ucoro::HeapFrameAllocator::deallocate(ptr, size);
+    }
+};
+
+/*
+ * *******************************************************************
+ *  Task
+ * *******************************************************************
+*/
+template<class Policy>
+ucoro::Task<void, Policy> task_spin() {
+    for (;;) {
+        sink = sink + 1;
+        co_yield_now();
+    }
+}
+
+template<class Policy>
+ucoro::Task<void, Policy> task_wait_event() {
+    for (;;) {
+        if constexpr (Policy::use_blocking) {
+            co_await make_interrupt_awaiter<EventType::TIMER1>();
+        } else {
+            co_yield_until(event_controller.consume<EventType::TIMER1>());
+        }
+        sink = sink + 1;
+    }
+}
+
+template<class Policy>
+void bench_task(const char* name) {
+    {
+        auto t = task_spin<Policy>();
+        t.resume();
+        report("resume", "task", name, iterations, ns_per_op(iterations, [&] {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                t.resume();
+            }
+        }));
+    }
+
+    {
+        std::vector<ucoro::Task<void, Policy>> tasks;
+        for (std::size_t i = 0; i < switch_instances; ++i) {
+            tasks.push_back(task_spin<Policy>());
+        }
+        const std::size_t rounds = iterations / switch_instances;
+        const std::size_t ops = rounds * switch_instances;
+
+        if constexpr (Policy::use_blocking) {
+            ucoro::Scheduler<Policy> sched;
+            for (auto& t : tasks) {
+                sched.spawn(t);
+            }
+            report("switch", "task", name, ops, ns_per_op(ops, [&] {
+                for (std::size_t r = 0; r < rounds; ++r) {
+                    sched.run_once();
+                }
+            }));
+            tasks.clear();      // detach before sched goes away
+        } else {
+            report("switch", "task", name, ops, ns_per_op(ops, [&] {
+                for (std::size_t r = 0; r < rounds; ++r) {
+                    for (auto& t : tasks) {
+                        t.resume();
+                    }
+                }
+            }));
+        }
+    }
+
+    {
+        auto t = task_wait_event<Policy>();
+        if constexpr (Policy::use_blocking) {
+            ucoro::Scheduler<Policy> sched;
+            sched.spawn(t);
+            sched.run_once();
+            report("wake", "task", name, iterations, ns_per_op(iterations, [&] {
+                for (std::size_t i = 0; i < iterations; ++i) {
+                    event_controller.pend<EventType::TIMER1>();
+                    sched.run_once();
+                }
+            }));
+            t = ucoro::Task<void, Policy>{};     // detach before sched goes away
+        } else {
+            t.resume();
+            report("wake", "task", name, iterations, ns_per_op(iterations, [&] {
+                for (std::size_t i = 0; i < iterations; ++i) {
+                    event_controller.pend<EventType::TIMER1>();
+                    t.resume();
+                }
+            }));
+        }
+    }
+}
+
+/*
+ * *******************************************************************
+ *  Many mostly-idle tasks: each parks itself until its own unblock()
+ * *******************************************************************
+*/
+constexpr std::size_t idle_task_count = 10000;
+
+using Parked = ucoro::BlockingMixin<ucoro::PlainPolicy>;
+
+struct ParkAwaitable {
+    Parked*& slot;
+
+    bool await_ready() const noexcept { return false; }
+
+    template<class Promise>
+    void await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        h.promise().block();
+        slot = &h.promise();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+ucoro::Task<void, ucoro::PlainPolicy> task_parked(Parked*& slot) {
+    for (;;) {
+        co_await ParkAwaitable{slot};
+        sink = sink + 1;
+    }
+}
+
+template<class Pass>
+void measure_idle_tasks(const char* model, bool scheduled, Pass&& pass) {
+    const std::size_t passes = iterations / 100 < 1000 ? 1000 : iterations / 100;
+
+    std::vector<Parked*> parked(idle_task_count);
+    ucoro::Scheduler<ucoro::PlainPolicy> sched;
+    std::vector<ucoro::Task<void, ucoro::PlainPolicy>> tasks;
+    for (std::size_t i = 0; i < idle_task_count; ++i) {
+        tasks.push_back(task_parked(parked[i]));
+    }
+    for (auto& t : tasks) {
+        if (scheduled) {
+            sched.spawn(t);
+        } else {
+            t.resume();
+        }
+    }
+    sched.run_once();
+
+    report("idle_tasks", model, "PlainPolicy", passes, ns_per_op(passes, [&] {
+        for (std::size_t i = 0; i < passes; ++i) {
+            parked[(i * 7919) % idle_task_count]->unblock();
+            pass(tasks, sched);
+        }
+    }));
+}
+
+void bench_idle_tasks() {
+    measure_idle_tasks("task_resume_all", false, [](auto& tasks, auto&) {
+        for (auto& t : tasks) {
+            t.resume();
+        }
+    });
+    measure_idle_tasks("task_scheduler", true, [](auto&, auto& sched) { sched.run_once(); });
+}
+
+/*
+ * *******************************************************************
+ *  Lazy sequences: Generator<T> vs. Task<T> + value()
+ * *******************************************************************
+*/
+struct Record256 {
+    std::uint32_t words[64];
+};
+
+template<class T>
+void next_item(T& item, std::uint32_t i) noexcept {
+    if constexpr (std::is_same_v<T, int>) {
+        item = static_cast<int>(i);
+    } else {
+        item.words[i % 64] = i;
+    }
+}
+
+template<class T>
+std::size_t item_key(const T& item) noexcept {
+    if constexpr (std::is_same_v<T, int>) {
+        return static_cast<std::size_t>(item);
+    } else {
+        return item.words[0];
+    }
+}
+
+template<class T>
+ucoro::Generator<T, ucoro::PlainPolicy> generate_items() {
+    T item{};
+    for (std::uint32_t i = 0;; ++i) {
+        next_item(item, i);
+        co_yield item;
+    }
+}
+
+template<class T>
+ucoro::Task<T, ucoro::PlainPolicy> task_items() {
+    T item{};
+    for (std::uint32_t i = 0;; ++i) {
+        next_item(item, i);
+        co_yield item;
+    }
+}
+
+template<class T>
+void measure_yield(const char* bench) {
+    {
+        auto gen = generate_items<T>();
+        auto it = gen.begin();
+        report(bench, "generator", "PlainPolicy", iterations, ns_per_op(iterations, [&] {
+            std::size_t acc = 0;
+            for (std::size_t i = 0; i < iterations; ++i, ++it) {
+                acc += item_key(*it);
+            }
+            sink = sink + acc;
+        }));
+    }
+    {
+        auto task = task_items<T>();
+        report(bench, "task_value", "PlainPolicy", iterations, ns_per_op(iterations, [&] {
+            std::size_t acc = 0;
+            for (std::size_t i = 0; i < iterations; ++i) {
+                task.resume();
+                acc += item_key(task.value());
+            }
+            sink = sink + acc;
+        }));
+    }
+}
+
+void bench_generator() {
+    measure_yield<int>("yield_int");
+    measure_yield<Record256>("yield_record");
+}
+
+// frame size of the same task body, default vs. compact error storage
+template<class Policy>
+void report_frame(const char* name) {
+    auto t = task_spin<ucoro::PooledPolicy<ProbeAllocator, Policy>>();
+    report_size("task", name, ProbeAllocator::last_size);
+}
+
+void report_frames() {
+    report_frame<ucoro::PlainPolicy>("PlainPolicy");
+    report_frame<ucoro::VolatilePolicy>("VolatilePolicy");
+    report_frame<ucoro::AtomicPolicy>("AtomicPolicy");
+    report_frame<ucoro::NoBlockPolicy>("NoBlockPolicy");
+    report_frame<ucoro::CompactPolicy<ucoro::NoError, ucoro::PlainPolicy>>("CompactPolicy<NoError,PlainPolicy>");
+    report_frame<ucoro::CompactPolicy<std::uint8_t, ucoro::PlainPolicy>>("CompactPolicy<uint8_t,PlainPolicy>");
+    report_frame<ucoro::CompactPolicy<ucoro::NoError, ucoro::AtomicPolicy>>("CompactPolicy<NoError,AtomicPolicy>");
+    report_frame<ucoro::CompactPolicy<ucoro::NoError, ucoro::NoBlockPolicy>>("CompactPolicy<NoError,NoBlockPolicy>");
+    report_frame<ucoro::CompactPolicy<std::uint8_t, ucoro::NoBlockPolicy>>("CompactPolicy<uint8_t,NoBlockPolicy>");
+    report_frame<ucoro::LeanPolicy<ucoro::PlainPolicy>>("LeanPolicy<PlainPolicy>");
+    report_frame<ucoro::LeanPolicy<ucoro::AtomicPolicy>>("LeanPolicy<AtomicPolicy>");
+    report_frame<ucoro::LeanPolicy<ucoro::NoBlockPolicy>>("LeanPolicy<NoBlockPolicy>");
+    report_frame<ucoro::CompactPolicy<ucoro::NoError, ucoro::LeanPolicy<ucoro::PlainPolicy>>>("CompactPolicy<NoError,LeanPolicy<PlainPolicy>>");
+}
+
+/*
+ * *******************************************************************
+ *  Wake latency under load: one urgent task waiting on an event,
+ *  switch_instances busy tasks yielding all the time
+ * *******************************************************************
+*/
+clock_type::time_point urgent_ran{};
+std::size_t urgent_runs = 0;
+
+template<class Policy>
+ucoro::Task<void, Policy> task_urgent() {
+    for (;;) {
+        co_await make_interrupt_awaiter<EventType::GPIO_PIN0>();
+        urgent_ran = clock_type::now();
+        ++urgent_runs;
+    }
+}
+
+void report_latency(const char* bench, const char* model, const char* policy, std::size_t ops, double avg, double max) {
+    std::printf("{\"bench\":\"%s\",\"model\":\"%s\",\"policy\":\"%s\",\"iterations\":%zu,\"ns_per_op\":%.3f,\"max_ns\":%.3f}\n",
+                bench, model, policy, ops, avg, max);
+}
+
+template<class Sched, class Spawn, class Step>
+void measure_loaded(const char* model, Sched& sched, Spawn&& spawn, Step&& step) {
+    using Policy = ucoro::PlainPolicy;
+    auto urgent = task_urgent<Policy>();
+    std::vector<ucoro::Task<void, Policy>> load;
+    for (std::size_t i = 0; i < switch_instances; ++i) {
+        load.push_back(task_spin<Policy>());
+    }
+    spawn(urgent, true);
+    for (auto& t : load) {
+        spawn(t, false);
+    }
+    step();
+
+    const std::size_t ops = iterations / switch_instances;
+    double total = 0;
+    double worst = 0;
+    for (std::size_t i = 0; i < ops; ++i) {
+        const std::size_t before = urgent_runs;
+        const auto start = clock_type::now();
+        event_controller.pend<EventType::GPIO_PIN0>();
+        while (urgent_runs == before) {
+            step();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(urgent_ran - start).count();
+        total += ns;
+        worst = ns > worst ? ns : worst;
+    }
+    report_latency("wake_loaded", model, "PlainPolicy", ops, total / static_cast<double>(ops), worst);
+    (void)sched;
+}
+
+void bench_priority() {
+    {
+        ucoro::Scheduler<ucoro::PlainPolicy> sched;
+        measure_loaded("task_fifo", sched,
+                       [&](auto& t, bool) { sched.spawn(t); },
+                       [&] { sched.run_once(); });
+    }
+    {
+        ucoro::PriorityScheduler<ucoro::PlainPolicy, 8> sched;
+        measure_loaded("task_priority", sched,
+                       [&](auto& t, bool urgent) { sched.spawn(t, urgent ? 7 : 0); },
+                       [&] { sched.run_next(); });
+    }
+}
+
+/*
+ * *******************************************************************
+ *  Idle host loop: the only task waits for an event that another
+ *  thread posts once per millisecond (an ISR stand-in)
+ * *******************************************************************
+*/
+constexpr std::size_t idle_samples = 200;
+
+std::atomic<std::int64_t> posted_at{0};
+std::atomic<std::size_t> idle_wakes{0};
+double idle_total = 0;
+double idle_worst = 0;
+
+std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count();
+}
+
+double thread_cpu_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e9 + static_cast<double>(ts.tv_nsec);
+}
+
+ucoro::Task<void, ucoro::PlainPolicy> task_idle_waiter() {
+    for (;;) {
+        co_await make_interrupt_awaiter<EventType::UART_RX>();
+        const double ns = static_cast<double>(now_ns() - posted_at.load(std::memory_order_acquire));
+        idle_total += ns;
+        idle_worst = ns > idle_worst ? ns : idle_worst;
+        const std::size_t n = idle_wakes.fetch_add(1, std::memory_order_release) + 1;
+        idle_wakes.notify_one();
+        if (n == idle_samples) {
+            co_return;
+        }
+    }
+}
+
+template<class Loop>
+void measure_idle(const char* model, Loop&& loop) {
+    ucoro::Scheduler<ucoro::PlainPolicy> sched;
+    auto waiter = task_idle_waiter();
+    sched.spawn(waiter);
+    sched.run_once();
+    idle_wakes.store(0);
+    idle_total = idle_worst = 0;
+
+    std::thread poster([] {
+        for (std::size_t i = 0; i < idle_samples; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            posted_at.store(now_ns(), std::memory_order_release);
+            event_controller.post<EventType::UART_RX>();
+            while (idle_wakes.load(std::memory_order_acquire) == i) {
+                idle_wakes.wait(i, std::memory_order_acquire);
+            }
+        }
+    });
+
+    const auto start = clock_type::now();
+    const double cpu_start = thread_cpu_ns();
+    loop(sched);
+    const double cpu = thread_cpu_ns() - cpu_start;
+    const double wall = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+    poster.join();
+
+    report_latency("wake_idle", model, "PlainPolicy", idle_samples, idle_total / static_cast<double>(idle_samples), idle_worst);
+    std::printf("{\"bench\":\"idle_cpu\",\"model\":\"%s\",\"policy\":\"PlainPolicy\",\"iterations\":%zu,\"cpu_percent\":%.3f}\n",
+                model, idle_samples, 100.0 * cpu / wall);
+}
+
+void bench_idle() {
+    measure_idle("task_busy_poll", [](auto& sched) {
+        while (sched.active()) {
+            event_controller.dispatch_posted();
+            sched.run_once();
+        }
+    });
+    measure_idle("task_fixed_sleep", [](auto& sched) {
+        while (sched.active()) {
+            event_controller.dispatch_posted();
+            sched.run_once();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    measure_idle("task_tickless", [](auto& sched) {
+        ucoro::TicklessLoop loop(sched);
+        loop.run();
+    });
+}
+
+/*
+ * *******************************************************************
+ *  Sleeping tasks: yield_timeout polls Time::now() on every pass,
+ *  sleep_for parks the task on the timer wheel until it expires
+ * *******************************************************************
+*/
+constexpr std::size_t sleep_tasks = 1000;
+
+ucoro::tick_t sleep_clock = 0;
+std::size_t sleep_resumes = 0;
+
+// clock read by the yield_timeout macro
+struct Time {
+    static ucoro::tick_t now() noexcept { return sleep_clock; }
+};
+
+ucoro::Task<void, ucoro::PlainPolicy> task_sleep_polled(ucoro::tick_t period) {
+    for (;;) {
+        bool timed_out = false;
+        yield_timeout(false, period, timed_out, (++sleep_resumes, std::suspend_always{}));
+        sink = sink + timed_out;
+    }
+}
+
+ucoro::Task<void, ucoro::PlainPolicy> task_sleep_wheel(ucoro::tick_t period) {
+    for (;;) {
+        co_await ucoro::sleep_for(period);
+        ++sleep_resumes;
+        sink = sink + 1;
+    }
+}
+
+template<class Make, class Tick>
+void measure_sleep(const char* model, Make&& make, Tick&& tick) {
+    const std::size_t ticks = iterations / 100 < 1000 ? 1000 : iterations / 100;
+
+    ucoro::Scheduler<ucoro::PlainPolicy> sched;
+    std::vector<ucoro::Task<void, ucoro::PlainPolicy>> tasks;
+    for (std::size_t i = 0; i < sleep_tasks; ++i) {
+        tasks.push_back(make(static_cast<ucoro::tick_t>(50 + i)));
+    }
+    for (auto& t : tasks) {
+        sched.spawn(t);
+    }
+    sched.run_once();
+    sleep_resumes = 0;
+
+    const double cpu_start = thread_cpu_ns();
+    for (std::size_t i = 0; i < ticks; ++i) {
+        tick();
+        sched.run_once();
+    }
+    const double cpu = thread_cpu_ns() - cpu_start;
+
+    std::printf("{\"bench\":\"sleep\",\"model\":\"%s\",\"policy\":\"PlainPolicy\",\"iterations\":%zu,"
+                "\"cpu_ns_per_tick\":%.3f,\"resumes_per_tick\":%.3f}\n",
+                model, ticks, cpu / static_cast<double>(ticks),
+                static_cast<double>(sleep_resumes) / static_cast<double>(ticks));
+}
+
+void bench_sleep() {
+    measure_sleep("task_yield_timeout", task_sleep_polled, [] { ++sleep_clock; });
+    measure_sleep("task_timer_wheel", task_sleep_wheel, [] { ucoro::timer_wheel.advance(ucoro::timer_wheel.now() + 1); });
+}
+
+/*
+ * *******************************************************************
+ *  WorkStealingExecutor scaling: the same batch of tasks on 1..N workers
+ * *******************************************************************
+*/
+constexpr std::size_t executor_tasks = 1024;
+
+ucoro::Task<void, ucoro::AtomicPolicy> task_compute(std::size_t steps) {
+    std::uint32_t x = static_cast<std::uint32_t>(steps);
+    for (std::size_t i = 0; i < steps; ++i) {
+        for (int k = 0; k < 256; ++k) {
+            x = x * 1664525u + 1013904223u;
+        }
+        co_yield_now();
+    }
+    sink = sink + x;
+}
+
+void bench_executor() {
+    const std::size_t steps = iterations / executor_tasks < 16 ? 16 : iterations / executor_tasks;
+    const std::size_t ops = steps * executor_tasks;
+    const unsigned cores = std::thread::hardware_concurrency() == 0 ? 1 : std::thread::hardware_concurrency();
+
+    for (unsigned workers = 1;; workers = workers * 2 < cores ? workers * 2 : cores) {
+        std::vector<ucoro::Task<void, ucoro::AtomicPolicy>> tasks;
+        for (std::size_t i = 0; i < executor_tasks; ++i) {
+            tasks.push_back(task_compute(steps));
+        }
+
+        ucoro::WorkStealingExecutor<> ex(workers);
+        const double ns = ns_per_op(ops, [&] {
+            for (auto& t : tasks) {
+                ex.spawn(t);
+            }
+            ex.wait();
+        });
+        std::printf("{\"bench\":\"executor\",\"model\":\"task\",\"policy\":\"AtomicPolicy\",\"workers\":%u,"
+                    "\"iterations\":%zu,\"ns_per_op\":%.3f}\n", workers, ops, ns);
+        if (workers == cores) {
+            break;
+        }
+    }
+}
+
+#if defined(__linux__)
+/*
+ * *******************************************************************
+ *  Loopback pipe on EpollReactor: the writer fills the pipe until
+ *  EAGAIN and awaits writable(), the reader drains it and awaits
+ *  readable(); one epoll_wait() per scheduler pass
+ * *******************************************************************
+*/
+ucoro::Task<void, ucoro::PlainPolicy> pipe_writer(int fd, std::size_t chunk, std::size_t bytes) {
+    static char buf[4096];
+    std::size_t sent = 0;
+    while (sent < bytes) {
+        const ssize_t n = write(fd, buf, chunk);
+        if (n > 0) {
+            sent += static_cast<std::size_t>(n);
+        } else if (errno != EAGAIN || !co_await ucoro::writable(fd)) {
+            break;
+        }
+    }
+    close(fd);
+}
+
+ucoro::Task<void, ucoro::PlainPolicy> pipe_reader(int fd, std::size_t chunk, std::size_t& received) {
+    static char buf[4096];
+    for (;;) {
+        const ssize_t n = read(fd, buf, chunk);
+        if (n > 0) {
+            received += static_cast<std::size_t>(n);
+        } else if (n == 0 || errno != EAGAIN || !co_await ucoro::readable(fd)) {
+            break;
+        }
+    }
+    close(fd);
+}
+
+void bench_pipe(std::size_t chunk) {
+    int fds[2];
+    if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+        return;
+    }
+    const std::size_t chunks = iterations / 4;
+    const std::size_t bytes = chunks * chunk;
+    std::size_t received = 0;
+
+    ucoro::Scheduler<ucoro::PlainPolicy> sched;
+    auto writer = pipe_writer(fds[1], chunk, bytes);
+    auto reader = pipe_reader(fds[0], chunk, received);
+    sched.spawn(writer);
+    sched.spawn(reader);
+    ucoro::TicklessLoop loop(sched, ucoro::epoll_reactor());
+
+    const auto start = clock_type::now();
+    loop.run();
+    const double ns = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+
+    char model[32];
+    std::snprintf(model, sizeof(model), "task_epoll_%zu", chunk);
+    std::printf("{\"bench\":\"pipe\",\"model\":\"%s\",\"policy\":\"PlainPolicy\",\"iterations\":%zu,"
+                "\"ns_per_op\":%.3f,\"mb_per_s\":%.1f}\n",
+                model, chunks, ns / static_cast<double>(chunks), static_cast<double>(received) * 1e3 / ns);
+}
+#endif
+
+/*
+ * *******************************************************************
+ *  Protothread
+ * *******************************************************************
+*/
+class ProtoSpin : public Protothread {
+public:
+    bool Run() override {
+        PT_BEGIN();
+        for (;;) {
+            sink = sink + 1;
+            PT_YIELD();
+        }
+        PT_END();
+    }
+};
+
+class ProtoWaitEvent : public Protothread {
+public:
+    bool Run() override {
+        PT_BEGIN();
+        for (;;) {
+            PT_WAIT_UNTIL(event_controller.consume<EventType::TIMER1>());
+            sink = sink + 1;
+        }
+        PT_END();
+    }
+};
+
+// 8 distinct thread types, so virtual calls through the base really differ per slot
+template<std::size_t K>
+class ProtoVirtualSpin final : public Protothread {
+public:
+    bool Run() override {
+        PT_BEGIN();
+        for (;;) {
+            sink = sink + K + 1;
+            PT_YIELD();
+        }
+        PT_END();
+    }
+};
+
+template<std::size_t K>
+class ProtoStaticSpin final : public StaticProtothread<ProtoStaticSpin<K>> {
+public:
+    bool Run() {
+        PT_BEGIN();
+        for (;;) {
+            sink = sink + K + 1;
+            PT_YIELD();
+        }
+        PT_END();
+    }
+};
+
+constexpr std::size_t dispatch_kinds = 8;
+
+template<std::size_t... I>
+auto make_virtual_spins(std::index_sequence<I...>) {
+    return std::make_tuple(ProtoVirtualSpin<I % dispatch_kinds>{}...);
+}
+
+template<std::size_t... I>
+ProtothreadScheduler<ProtoStaticSpin<I % dispatch_kinds>...> make_static_spins(std::index_sequence<I...>) {
+    return {};
+}
+
+void bench_proto_dispatch() {
+    const std::size_t rounds = iterations / switch_instances;
+    const std::size_t ops = rounds * switch_instances;
+
+    {
+        auto threads = make_virtual_spins(std::make_index_sequence<switch_instances>{});
+        std::vector<Protothread*> pts;
+        std::apply([&](auto&... pt) { (pts.push_back(&pt), ...); }, threads);
+        report("dispatch", "proto", "virtual", ops, ns_per_op(ops, [&] {
+            for (std::size_t r = 0; r < rounds; ++r) {
+                for (Protothread* pt : pts) {
+                    if (pt->IsRunning()) {
+                        pt->Run();
+                    }
+                }
+            }
+        }));
+    }
+
+    {
+        auto threads = make_static_spins(std::make_index_sequence<switch_instances>{});
+        report("dispatch", "proto", "crtp", ops, ns_per_op(ops, [&] {
+            for (std::size_t r = 0; r < rounds; ++r) {
+                sink = sink + threads.RunOnce();
+            }
+        }));
+    }
+
+    report_size("proto", "crtp", sizeof(ProtoStaticSpin<0>));
+}
+
+// the former PT_YIELD(): the source line is the state
+#define BENCH_PT_LINE_YIELD()                                               \
+    do {                                                                    \
+            ptYielded = false;                                              \
+            this->_ptLine = __LINE__;                                       \
+        /* fall through */                                                  \
+        case __LINE__:                                                      \
+            if (!ptYielded) {                                               \
+                return true;                                                \
+            }                                                               \
+    } while (0)
+
+class ProtoDensePoints final : public StaticProtothread<ProtoDensePoints> {
+public:
+    bool Run() {
+        PT_BEGIN();
+        for (;;) {
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+            sink = sink + 1;
+            PT_YIELD();
+        }
+        PT_END();
+    }
+};
+
+class ProtoLinePoints final : public StaticProtothread<ProtoLinePoints, unsigned int> {
+public:
+    bool Run() {
+        PT_BEGIN();
+        for (;;) {
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+            sink = sink + 1;
+            BENCH_PT_LINE_YIELD();
+        }
+        PT_END();
+    }
+};
+
+#undef BENCH_PT_LINE_YIELD
+
+constexpr std::size_t wait_point_runs = 7;
+
+template<class Thread>
+void bench_wait_points(const char* policy) {
+    std::vector<Thread> pts(switch_instances);
+    for (std::size_t i = 0; i < pts.size(); ++i) {
+        for (std::size_t k = 0; k <= i % 32; ++k) {
+            pts[i].Run();
+        }
+    }
+
+    // the two variants differ by a few cycles at most; one timed run is dominated
+    // by noise (frequency ramp, other processes), so report the best of several
+    const std::size_t rounds = iterations / switch_instances;
+    const std::size_t ops = rounds * switch_instances;
+    double best = 0.0;
+    for (std::size_t run = 0; run < wait_point_runs; ++run) {
+        const double ns = ns_per_op(ops, [&] {
+            for (std::size_t r = 0; r < rounds; ++r) {
+                for (auto& pt : pts) {
+                    pt.Run();
+                }
+            }
+        });
+        best = (run == 0 || ns < best) ? ns : best;
+    }
+    report("wait_points", "proto", policy, ops, best);
+    report_size("proto", policy, sizeof(Thread));
+}
+
+void bench_proto() {
+    {
+        ProtoSpin pt;
+        pt.Run();
+        report("resume", "proto", "none", iterations, ns_per_op(iterations, [&] {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                pt.Run();
+            }
+        }));
+    }
+
+    {
+        std::vector<ProtoSpin> pts(switch_instances);
+        const std::size_t rounds = iterations / switch_instances;
+        const std::size_t ops = rounds * switch_instances;
+        report("switch", "proto", "none", ops, ns_per_op(ops, [&] {
+            for (std::size_t r = 0; r < rounds; ++r) {
+                for (auto& pt : pts) {
+                    pt.Run();
+                }
+            }
+        }));
+    }
+
+    {
+        ProtoWaitEvent pt;
+        pt.Run();
+        report("wake", "proto", "none", iterations, ns_per_op(iterations, [&] {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                event_controller.pend<EventType::TIMER1>();
+                pt.Run();
+            }
+        }));
+    }
+
+    report_size("proto", "none", sizeof(ProtoSpin));
+}
+
+/*
+ * *******************************************************************
+ *  InstantCoroutine
+ * *******************************************************************
+*/
+CoroutineDefine(InstantSpin) {
+    CoroutineBegin(void)
+        for (;;) {
+            sink = sink + 1;
+            CoroutineYield();
+        }
+    CoroutineEnd()
+};
+
+CoroutineDefine(InstantWaitEvent) {
+    CoroutineBegin(void)
+        for (;;) {
+            CoroutineYieldUntil(event_controller.consume<EventType::TIMER1>());
+            sink = sink + 1;
+        }
+    CoroutineEnd()
+};
+
+void bench_instant() {
+    {
+        InstantSpin c;
+        c();
+        report("resume", "instant", "none", iterations, ns_per_op(iterations, [&] {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                c();
+            }
+        }));
+    }
+
+    {
+        std::vector<InstantSpin> cs(switch_instances);
+        const std::size_t rounds = iterations / switch_instances;
+        const std::size_t ops = rounds * switch_instances;
+        report("switch", "instant", "none", ops, ns_per_op(ops, [&] {
+            for (std::size_t r = 0; r < rounds; ++r) {
+                for (auto& c : cs) {
+                    c();
+                }
+            }
+        }));
+    }
+
+    {
+        InstantWaitEvent c;
+        c();
+        report("wake", "instant", "none", iterations, ns_per_op(iterations, [&] {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                event_controller.pend<EventType::TIMER1>();
+                c();
+            }
+        }));
+    }
+
+    report_size("instant", "none", sizeof(InstantSpin));
+}
+
+// consumer of decoded bytes (plain function object, so the decompressor dominates)
+struct RleCounter {
+    std::uint32_t sum = 0;
+    void operator()(int c) { sum += static_cast<std::uint32_t>(c); }
+};
+
+// the Decompressor example of InstantCoroutine.h, byte by byte ...
+CoroutineDefine(RleDecompressor) {
+    unsigned len = 0;
+public:
+    RleCounter parser;
+
+    CoroutineBegin(void, int c)
+        for (;;) {
+            if (c == 0xFF) {
+                CoroutineYield();
+                len = static_cast<unsigned>(c);
+                CoroutineYield();
+                while (len--) {
+                    parser(c);
+                }
+            } else {
+                parser(c);
+            }
+            CoroutineYield();
+        }
+    CoroutineEnd()
+};
+
+// ... and batched
+CoroutineDefine(RleBatchDecompressor) {
+    unsigned len = 0;
+public:
+    RleCounter parser;
+
+    CoroutinePushBegin(int, c)
+        for (;;) {
+            if (c == 0xFF) {
+                CoroutinePushYield();
+                len = static_cast<unsigned>(c);
+                CoroutinePushYield();
+                while (len--) {
+                    parser(c);
+                }
+            } else {
+                parser(c);
+            }
+            CoroutinePushYield();
+        }
+    CoroutineEnd()
+};
+
+// expands an RLE buffer, one decoded byte per value
+CoroutineDefine(RleExpander) {
+    const int* in = nullptr;
+    const int* end = nullptr;
+    unsigned len = 0;
+public:
+    void reset(const int* first, const int* last) {
+        in = first;
+        end = last;
+        Restart();
+    }
+
+    CoroutineBegin(int)
+        for (; in != end; ++in) {
+            if (*in == 0xFF) {
+                len = static_cast<unsigned>(in[1]);
+                in += 2;
+                for (; len != 0; --len) {
+                    CoroutineYield(*in);
+                }
+            } else {
+                CoroutineYield(*in);
+            }
+        }
+        CoroutineStop(-1);
+    CoroutineEnd()
+};
+
+CoroutineDefine(RleBatchExpander) {
+    const int* in = nullptr;
+    const int* end = nullptr;
+    unsigned len = 0;
+public:
+    void reset(const int* first, const int* last) {
+        in = first;
+        end = last;
+        Restart();
+    }
+
+    CoroutinePullBegin(int)
+        for (; in != end; ++in) {
+            if (*in == 0xFF) {
+                len = static_cast<unsigned>(in[1]);
+                in += 2;
+                for (; len != 0; --len) {
+                    CoroutinePullYield(*in);
+                }
+            } else {
+                CoroutinePullYield(*in);
+            }
+        }
+        CoroutinePullStop();
+    CoroutineEnd()
+};
+
+// text with a run of 2..9 repeated bytes every 8 literals
+std::vector<int> rle_input(std::size_t bytes, std::size_t& decoded) {
+    std::vector<int> in;
+    decoded = 0;
+    for (std::size_t i = 0; in.size() < bytes; ++i) {
+        if (i % 8 == 7) {
+            in.push_back(0xFF);
+            in.push_back(static_cast<int>(2 + i % 8));
+            in.push_back('a' + static_cast<int>(i % 26));
+            decoded += 2 + i % 8;
+        } else {
+            in.push_back("lorem ipsum dolor"[i % 17]);
+            ++decoded;
+        }
+    }
+    return in;
+}
+
+// entry points as seen from another translation unit (not inlined into the loops)
+[[gnu::noinline]] void rle_push_one(RleDecompressor& d, int c) {
+    d(c);
+}
+
+[[gnu::noinline]] std::size_t rle_push_batch(RleBatchDecompressor& d, const int* in, std::size_t n) {
+    return d.Push(in, n);
+}
+
+[[gnu::noinline]] int rle_pull_one(RleExpander& g) {
+    return g();
+}
+
+[[gnu::noinline]] std::size_t rle_pull_batch(RleBatchExpander& g, int* out, std::size_t n) {
+    return g.Pull(out, n);
+}
+
+void bench_instant_rle() {
+    std::size_t decoded = 0;
+    const std::vector<int> in = rle_input(64 * 1024, decoded);
+    const std::size_t passes = iterations / decoded < 4 ? 4 : iterations / decoded;
+    const std::size_t ops = passes * decoded;
+
+    {
+        RleDecompressor d;
+        report("rle_push", "instant", "per_call", ops, ns_per_op(ops, [&] {
+            for (std::size_t p = 0; p < passes; ++p) {
+                for (int c : in) {
+                    rle_push_one(d, c);
+                }
+            }
+        }));
+        sink = sink + d.parser.sum;
+    }
+
+    {
+        RleBatchDecompressor d;
+        report("rle_push", "instant", "batch", ops, ns_per_op(ops, [&] {
+            for (std::size_t p = 0; p < passes; ++p) {
+                rle_push_batch(d, in.data(), in.size());
+            }
+        }));
+        sink = sink + d.parser.sum;
+    }
+
+    {
+        RleExpander g;
+        RleCounter counter;
+        report("rle_pull", "instant", "per_call", ops, ns_per_op(ops, [&] {
+            for (std::size_t p = 0; p < passes; ++p) {
+                g.reset(in.data(), in.data() + in.size());
+                for (;;) {
+                    const int c = rle_pull_one(g);
+                    if (!g) {
+                        break;
+                    }
+                    counter(c);
+                }
+            }
+        }));
+        sink = sink + counter.sum;
+    }
+
+    {
+        RleBatchExpander g;
+        RleCounter counter;
+        int out[256];
+        report("rle_pull", "instant", "batch", ops, ns_per_op(ops, [&] {
+            for (std::size_t p = 0; p < passes; ++p) {
+                g.reset(in.data(), in.data() + in.size());
+                while (g) {
+                    const std::size_t n = rle_pull_batch(g, out, 256);
+                    for (std::size_t i = 0; i < n; ++i) {
+                        counter(out[i]);
+                    }
+                }
+            }
+        }));
+        sink = sink + counter.sum;
+    }
+}
+
+// one "sensor": hot counters plus rarely used calibration data
+struct SensorFields {
+    unsigned limit = 0;
+    unsigned samples = 0;
+    std::uint32_t sum = 0;
+    std::uint8_t calibration[52] = {};
+};
+
+CoroutineDefine(SensorObject) {
+public:
+    SensorFields f;
+
+    CoroutineBegin(void)
+        for (;;) {
+            f.sum += f.samples;
+            if (++f.samples == f.limit) {
+                CoroutineStop();
+            }
+            CoroutineYield();
+        }
+    CoroutineEnd()
+};
+
+CoroutineBulkDefine(SensorBulk, SensorFields) {
+    CoroutineBulkBegin(void)
+        for (;;) {
+            fields.sum += fields.samples;
+            if (++fields.samples == fields.limit) {
+                CoroutineStop();
+            }
+            CoroutineYield();
+        }
+    CoroutineEnd()
+};
+
+constexpr std::size_t bulk_instances = 16384;
+
+unsigned bulk_limit(std::size_t i) {
+    return i % 4 == 0 ? ~0u : 4;
+}
+
+void bench_instant_bulk() {
+    const std::size_t rounds = iterations / bulk_instances < 16 ? 16 : iterations / bulk_instances;
+    const std::size_t ops = rounds * bulk_instances;
+
+    {
+        std::vector<SensorObject> objects(bulk_instances);
+        for (std::size_t i = 0; i < objects.size(); ++i) {
+            objects[i].f.limit = bulk_limit(i);
+        }
+        report("bulk", "instant", "objects", ops, ns_per_op(ops, [&] {
+            for (std::size_t r = 0; r < rounds; ++r) {
+                for (auto& c : objects) {
+                    if (c) {
+                        c();
+                    }
+                }
+            }
+        }));
+    }
+
+    {
+        auto bulk = std::make_unique<CoroutineBulk<SensorBulk, bulk_instances>>();
+        for (std::size_t i = 0; i < bulk_instances; ++i) {
+            (*bulk)[i].limit = bulk_limit(i);
+        }
+        report("bulk", "instant", "soa", ops, ns_per_op(ops, [&] {
+            for (std::size_t r = 0; r < rounds; ++r) {
+                sink = sink + bulk->RunAll();
+            }
+        }));
+    }
+}
+
+class MixedSpin final : public StaticProtothread<MixedSpin> {
+public:
+    bool Run() {
+        PT_BEGIN();
+        for (;;) {
+            sink = sink + 1;
+            PT_YIELD();
+        }
+        PT_END();
+    }
+};
+
+void bench_mixed() {
+    {
+        ucoro::Scheduler<ucoro::PlainPolicy> sched;
+        auto task = task_spin<ucoro::PlainPolicy>();
+        sched.spawn(task);
+        MixedSpin pt;
+        InstantSpin c;
+        report("mixed", "mixed", "hand_loop", iterations, ns_per_op(iterations, [&] {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                sched.run_once();
+                if (pt.IsRunning()) {
+                    pt.Run();
+                }
+                if (c) {
+                    c();
+                }
+            }
+        }));
+    }
+
+    {
+        MixedSpin pt;
+        InstantSpin c;
+        ucoro::MixedScheduler sched(task_spin<ucoro::PlainPolicy>(), pt, c);
+        report("mixed", "mixed", "MixedScheduler", iterations, ns_per_op(iterations, [&] {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                sched.run_once();
+            }
+        }));
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations < switch_instances) {
+            iterations = switch_instances;
+        }
+    }
+
+    bench_task<ucoro::PlainPolicy>("PlainPolicy");
+    bench_task<ucoro::VolatilePolicy>("VolatilePolicy");
+    bench_task<ucoro::AtomicPolicy>("AtomicPolicy");
+    bench_task<ucoro::NoBlockPolicy>("NoBlockPolicy");
+    bench_idle_tasks();
+    bench_generator();
+    report_frames();
+    bench_priority();
+    bench_idle();
+    bench_sleep();
+    bench_executor();
+#if defined(__linux__)
+    bench_pipe(64);
+    bench_pipe(4096);
+#endif
+    bench_proto();
+    bench_proto_dispatch();
+    bench_wait_points<ProtoDensePoints>("counter");
+    bench_wait_points<ProtoLinePoints>("line");
+    bench_instant();
+    bench_instant_bulk();
+    bench_instant_rle();
+    bench_mixed();
+    return 0;
+}
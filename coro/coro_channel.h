@@ -0,0 +1,531 @@
+#ifndef CORO_CHANNEL_H
+#define CORO_CHANNEL_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+#include "coro_promise.h"
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+namespace ucoro {
+
+/*
+ * *******************************************************************
+ *  RingBuffer:
+ *  fixed-capacity FIFO for a single execution context (no atomics)
+ * *******************************************************************
+*/
+template<class T, std::size_t Capacity>
+class RingBuffer {
+    static_assert(Capacity > 0, "[UCORO]: RingBuffer capacity must be > 0");
+
+public:
+    static constexpr std::size_t capacity = Capacity;
+
+    bool try_push(T& v) noexcept {
+        if (count == Capacity) {
+            return false;
+        }
+        buf[(head + count) % Capacity] = std::move(v);
+        ++count;
+        return true;
+    }
+
+    bool try_pop(T& out) noexcept {
+        if (count == 0) {
+            return false;
+        }
+        out = std::move(buf[head]);
+        head = (head + 1) % Capacity;
+        --count;
+        return true;
+    }
+
+    std::size_t size() const noexcept { return count; }
+
+private:
+    T buf[Capacity]{};
+    std::size_t head = 0;
+    std::size_t count = 0;
+};
+
+/*
+ * *******************************************************************
+ *  MpmcRing:
+ *  bounded lock-free multi-producer / multi-consumer queue
+ *  (D. Vyukov), one sequence number per cell. Capacity: power of two.
+ * *******************************************************************
+*/
+template<class T, std::size_t Capacity>
+class MpmcRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "[UCORO]: MpmcRing capacity must be a power of two >= 2");
+
+public:
+    static constexpr std::size_t capacity = Capacity;
+
+    MpmcRing() noexcept {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_push(T& v) noexcept {
+        std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(v);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& out) noexcept {
+        std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;   // empty
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(cell->data);
+        cell->seq.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // approximate under concurrency
+    std::size_t size() const noexcept {
+        return enqueue_pos.load(std::memory_order_relaxed) - dequeue_pos.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::size_t mask = Capacity - 1;
+
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        T data{};
+    };
+
+    Cell cells[Capacity];
+    alignas(64) std::atomic<std::size_t> enqueue_pos{0};
+    alignas(64) std::atomic<std::size_t> dequeue_pos{0};
+};
+
+/*
+ * *******************************************************************
+ *  ChannelWaiter:
+ *  intrusive node of a task parked in send()/receive(), lives in the
+ *  awaitable. `slot` is the value to hand over (send) or the place to
+ *  put the received value (receive).
+ * *******************************************************************
+*/
+struct SelectGroup {
+    int selected = -1;
+
+    bool claim(int index) noexcept {
+        if (selected >= 0) {
+            return false;
+        }
+        selected = index;
+        return true;
+    }
+};
+
+template<class T, class Policy>
+struct ChannelWaiter {
+    ChannelWaiter* next = nullptr;
+    ChannelWaiter* prev = nullptr;
+    bool linked = false;
+    T* slot = nullptr;
+    Waker waker{};
+    SelectGroup* group = nullptr;
+    int index = 0;
+    typename Policy::template block_t<bool> done{false};
+
+    bool is_done() const noexcept {
+        if constexpr (Policy::is_atomic) {
+            return done.load(std::memory_order_acquire);
+        } else {
+            return done;
+        }
+    }
+
+    void complete() noexcept {
+        const Waker wake = waker;     // the awaitable may be gone once `done` is seen
+        if constexpr (Policy::is_atomic) {
+            done.store(true, std::memory_order_release);
+        } else {
+            done = true;
+        }
+        wake();
+    }
+};
+
+template<class Node>
+struct WaiterList {
+    Node* head = nullptr;
+    Node* tail = nullptr;
+
+    bool empty() const noexcept { return head == nullptr; }
+
+    void push(Node& n) noexcept {
+        n.prev = tail;
+        n.next = nullptr;
+        (tail ? tail->next : head) = &n;
+        tail = &n;
+        n.linked = true;
+    }
+
+    void remove(Node& n) noexcept {
+        (n.prev ? n.prev->next : head) = n.next;
+        (n.next ? n.next->prev : tail) = n.prev;
+        n.next = n.prev = nullptr;
+        n.linked = false;
+    }
+};
+
+/*
+ * *******************************************************************
+ *  BasicChannel:
+ *  bounded channel on top of a ring. send()/receive() complete without
+ *  suspending while the ring is not full/empty; otherwise the task is
+ *  parked (block()) and the opposite side finishes the operation for
+ *  it and wakes it (unblock()) — woken tasks never retry.
+ *  Atomic policies: lock-free ring, waiter lists behind a tiny lock
+ *  that is only try-locked from try_send()/try_receive(), so those two
+ *  may be called from another thread or a signal handler / ISR.
+ * *******************************************************************
+*/
+template<class T, class Ring, class Policy>
+class BasicChannel {
+public:
+    using value_type = T;
+    using policy_t = Policy;
+    using waiter_t = ChannelWaiter<T, Policy>;
+
+    static constexpr std::size_t capacity = Ring::capacity;
+
+    BasicChannel() noexcept = default;
+    BasicChannel(const BasicChannel&) = delete;
+    BasicChannel& operator=(const BasicChannel&) = delete;
+
+    // non-blocking; true if the value went into the channel (v is moved from)
+    bool try_send(T& v) noexcept {
+        if (!ring.try_push(v)) {
+            return false;
+        }
+        settle();
+        return true;
+    }
+
+    bool try_send(T&& v) noexcept { return try_send(v); }
+
+    // non-blocking; true if a value was received into out
+    bool try_receive(T& out) noexcept {
+        if (!ring.try_pop(out)) {
+            return false;
+        }
+        settle();
+        return true;
+    }
+
+    std::size_t size() const noexcept { return ring.size(); }
+
+    struct SendAwaitable {
+        BasicChannel& ch;
+        T value;
+        waiter_t waiter{};
+
+        SendAwaitable(BasicChannel& c, T v) noexcept : ch(c), value(std::move(v)) {}
+        SendAwaitable(const SendAwaitable&) = delete;
+        SendAwaitable& operator=(const SendAwaitable&) = delete;
+        ~SendAwaitable() { ch.cancel(ch.senders, waiter); }
+
+        bool await_ready() noexcept { return ch.try_send(value); }
+
+        template<class Promise>
+        bool await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            static_assert(Promise::policy_t::use_blocking, "You must use blocking type Task");
+            waiter.slot = &value;
+            return ch.park(ch.senders, waiter, h.promise());
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    struct ReceiveAwaitable {
+        BasicChannel& ch;
+        T value{};
+        waiter_t waiter{};
+
+        explicit ReceiveAwaitable(BasicChannel& c) noexcept : ch(c) {}
+        ReceiveAwaitable(const ReceiveAwaitable&) = delete;
+        ReceiveAwaitable& operator=(const ReceiveAwaitable&) = delete;
+        ~ReceiveAwaitable() { ch.cancel(ch.receivers, waiter); }
+
+        bool await_ready() noexcept { return ch.try_receive(value); }
+
+        template<class Promise>
+        bool await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            static_assert(Promise::policy_t::use_blocking, "You must use blocking type Task");
+            waiter.slot = &value;
+            return ch.park(ch.receivers, waiter, h.promise());
+        }
+
+        T await_resume() noexcept { return std::move(value); }
+    };
+
+    // co_await ch.send(x) — suspends only while the channel is full
+    SendAwaitable send(T v) noexcept { return {*this, std::move(v)}; }
+
+    // T x = co_await ch.receive() — suspends only while the channel is empty
+    ReceiveAwaitable receive() noexcept { return ReceiveAwaitable{*this}; }
+
+    // select() case: receive into `out`
+    struct ReceiveCase {
+        BasicChannel& ch;
+        T& out;
+    };
+    ReceiveCase receive_into(T& out) noexcept { return {*this, out}; }
+
+private:
+    template<class...> friend struct SelectAwaitable;
+
+    // register a waiter and finish the operation if the ring changed meanwhile;
+    // returns false if it is already done (do not suspend)
+    template<class Promise>
+    bool park(WaiterList<waiter_t>& list, waiter_t& w, Promise& promise) noexcept {
+        promise.block();
+        w.waker = Waker::of(promise);
+
+        lock();
+        list.push(w);
+        unlock();
+        settle();
+
+        // atomic: another thread may still be inside unblock() — always suspend,
+        // the scheduler requeues us if we are already unblocked
+        if constexpr (Policy::is_atomic) {
+            return true;
+        } else {
+            return !w.is_done();
+        }
+    }
+
+    void cancel(WaiterList<waiter_t>& list, waiter_t& w) noexcept {
+        lock();
+        if (w.linked) {
+            list.remove(w);
+        }
+        unlock();
+
+        // a settle() that found the lock taken meanwhile left its work to the holder — us
+        if constexpr (Policy::is_atomic) {
+            if (settle_requested.load(std::memory_order_seq_cst)) {
+                settle();
+            }
+        }
+    }
+
+    // hand ring contents to parked receivers and free space to parked senders
+    void settle() noexcept {
+        if constexpr (Policy::is_atomic) {
+            // combining: whoever holds the lock re-runs settle for everybody who asked
+            settle_requested.store(true, std::memory_order_seq_cst);
+            while (settle_requested.load(std::memory_order_seq_cst)) {
+                if (guard.test_and_set(std::memory_order_acquire)) {
+                    return;
+                }
+                settle_requested.store(false, std::memory_order_seq_cst);
+                settle_locked();
+                guard.clear(std::memory_order_release);
+            }
+        } else {
+            settle_locked();
+        }
+    }
+
+    void settle_locked() noexcept {
+        bool progress = true;
+        while (progress) {
+            progress = false;
+
+            while (!receivers.empty()) {
+                waiter_t& w = *receivers.head;
+                if (w.group && w.group->selected >= 0 && w.group->selected != w.index) {
+                    receivers.remove(w);    // another case of its select() already won
+                    continue;
+                }
+                if (!ring.try_pop(*w.slot)) {
+                    break;
+                }
+                if (w.group) {
+                    w.group->claim(w.index);
+                }
+                receivers.remove(w);
+                w.complete();
+                progress = true;
+            }
+
+            while (!senders.empty()) {
+                waiter_t& w = *senders.head;
+                if (!ring.try_push(*w.slot)) {
+                    break;
+                }
+                senders.remove(w);
+                w.complete();
+                progress = true;
+            }
+        }
+    }
+
+    void lock() noexcept {
+        if constexpr (Policy::is_atomic) {
+            while (guard.test_and_set(std::memory_order_acquire)) {
+            }
+        }
+    }
+
+    void unlock() noexcept {
+        if constexpr (Policy::is_atomic) {
+            guard.clear(std::memory_order_release);
+        }
+    }
+
+    using flag_t = std::conditional_t<Policy::is_atomic, std::atomic_flag, NoHook>;
+    using request_t = std::conditional_t<Policy::is_atomic, std::atomic<bool>, NoHook>;
+
+    Ring ring{};
+    WaiterList<waiter_t> senders{};
+    WaiterList<waiter_t> receivers{};
+    [[no_unique_address]] flag_t guard{};
+    [[no_unique_address]] request_t settle_requested{};
+};
+
+// single execution context (tasks of one Scheduler), no atomics at all
+template<class T, std::size_t Capacity, class Policy = PlainPolicy>
+class Channel : public BasicChannel<T, RingBuffer<T, Capacity>, Policy> {
+    static_assert(!Policy::is_atomic, "[UCORO]: use MpmcChannel with an atomic policy");
+};
+
+// any number of producers/consumers across threads, signal/ISR-safe try_send/try_receive
+template<class T, std::size_t Capacity, class Policy = AtomicPolicy>
+class MpmcChannel : public BasicChannel<T, MpmcRing<T, Capacity>, Policy> {
+    static_assert(Policy::is_atomic, "[UCORO]: MpmcChannel needs an atomic policy");
+};
+
+/*
+ * *******************************************************************
+ *  select:
+ *  wait on several single-context channels at once, receive from the
+ *  first one that has data. Returns the index of the winning case.
+ *
+ *  int a; Msg b;
+ *  switch (co_await ucoro::select(ch_a.receive_into(a), ch_b.receive_into(b))) { ... }
+ * *******************************************************************
+*/
+template<class... Cases>
+struct SelectAwaitable {
+    std::tuple<Cases...> cases;
+    std::tuple<typename std::remove_reference_t<decltype(std::declval<Cases&>().ch)>::waiter_t...> waiters{};
+    SelectGroup group{};
+
+    explicit SelectAwaitable(Cases... c) noexcept : cases(c...) {}
+    SelectAwaitable(const SelectAwaitable&) = delete;
+    SelectAwaitable& operator=(const SelectAwaitable&) = delete;
+    ~SelectAwaitable() { unlink_all(); }
+
+    bool await_ready() noexcept {
+        std::apply([&](auto&... c) {
+            int i = 0;
+            ((group.selected < 0 && c.ch.try_receive(c.out) ? (void)(group.selected = i) : (void)0, ++i), ...);
+        }, cases);
+        return group.selected >= 0;
+    }
+
+    template<class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        static_assert(Promise::policy_t::use_blocking, "You must use blocking type Task");
+
+        auto& promise = h.promise();
+        promise.block();
+        const Waker waker = Waker::of(promise);
+
+        link_all(waker, std::index_sequence_for<Cases...>{});
+
+        if (group.selected >= 0) {
+            unlink_all();
+            return false;
+        }
+        return true;
+    }
+
+    int await_resume() noexcept {
+        unlink_all();
+        return group.selected;
+    }
+
+private:
+    template<std::size_t... I>
+    void link_all(const Waker& waker, std::index_sequence<I...>) noexcept {
+        ((group.selected < 0 ? link_one<I>(waker) : void()), ...);
+    }
+
+    template<std::size_t I>
+    void link_one(const Waker& waker) noexcept {
+        auto& c = std::get<I>(cases);
+        auto& w = std::get<I>(waiters);
+        w.slot = &c.out;
+        w.waker = waker;
+        w.group = &group;
+        w.index = static_cast<int>(I);
+        c.ch.receivers.push(w);
+        c.ch.settle();
+    }
+
+    void unlink_all() noexcept {
+        unlink_each(std::index_sequence_for<Cases...>{});
+    }
+
+    template<std::size_t... I>
+    void unlink_each(std::index_sequence<I...>) noexcept {
+        ((std::get<I>(waiters).linked ? std::get<I>(cases).ch.receivers.remove(std::get<I>(waiters)) : void()), ...);
+    }
+};
+
+template<class... Cases>
+SelectAwaitable<Cases...> select(Cases... cases) noexcept {
+    static_assert(sizeof...(Cases) > 0, "[UCORO]: select() needs at least one case");
+    static_assert((!std::remove_reference_t<decltype(cases.ch)>::policy_t::is_atomic && ...),
+                  "[UCORO]: select() works on single-context channels only");
+    return SelectAwaitable<Cases...>{cases...};
+}
+
+} /* namespace ucoro */
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_CHANNEL_H
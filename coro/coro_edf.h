@@ -0,0 +1,273 @@
+#ifndef CORO_EDF_H
+#define CORO_EDF_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+#include "coro_scheduler.h"
+#include "coro_timer.h"
+#include <cstdint>
+#include <utility>
+
+namespace ucoro {
+
+// ReadyLink::sched_flags bits: sched_key holds a deadline / the task is attached to an EdfScheduler
+inline constexpr std::uint8_t sched_has_deadline = 0x01;
+inline constexpr std::uint8_t sched_deadline_sink = 0x02;
+
+/*
+ * *******************************************************************
+ *  Deadline awaitables (never suspend):
+ *  co_await ucoro::set_deadline(t)     — absolute, in timer ticks
+ *  co_await ucoro::deadline_after(d)   — timer_wheel.now() + d
+ *  co_await ucoro::clear_deadline()    — back to background
+ *  Only a task of an EdfScheduler has a deadline; elsewhere (other
+ *  scheduler, none) they do nothing, sched_key stays the sink's.
+ *  Set the deadline of the next activation before blocking for it:
+ *
+ *  for (;;) {
+ *      co_await ucoro::set_deadline(release + budget);
+ *      co_await ucoro::sleep_until(release);
+ *      control_step();
+ *      release += period;
+ *  }
+ * *******************************************************************
+*/
+struct DeadlineAwaiter {
+    tick_t deadline;
+    bool clear;
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    template<class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        static_assert(Promise::policy_t::use_blocking, "[UCORO]: deadlines need a blocking policy");
+        ReadyLink<typename Promise::policy_t>& link = h.promise().chain_root();
+        if ((link.sched_flags & sched_deadline_sink) == 0) {
+            return false;
+        }
+        if (clear) {
+            link.sched_flags = static_cast<std::uint8_t>(link.sched_flags & ~sched_has_deadline);
+        } else {
+            link.sched_key = deadline;
+            link.sched_flags = static_cast<std::uint8_t>(link.sched_flags | sched_has_deadline);
+        }
+        return false;
+    }
+
+    constexpr void await_resume() const noexcept {}
+};
+
+inline DeadlineAwaiter set_deadline(tick_t deadline) noexcept {
+    return {deadline, false};
+}
+
+template<class Wheel = default_timer_wheel>
+DeadlineAwaiter deadline_after(tick_t delay, Wheel& wheel = timer_wheel) noexcept {
+    return {static_cast<tick_t>(wheel.now() + delay), false};
+}
+
+inline DeadlineAwaiter clear_deadline() noexcept {
+    return {0, true};
+}
+
+/*
+ * *******************************************************************
+ *  EdfScheduler:
+ *  earliest-deadline-first. Runnable tasks with a deadline sit in an
+ *  intrusive pairing heap keyed by deadline (wrap-around safe); the
+ *  heap reuses the ready hook (next = sibling, prev = first child), so
+ *  no memory beyond the promise. Tasks without a deadline run FIFO
+ *  only when no deadline task is ready.
+ *  An activation ends when the task blocks or finishes; if that is
+ *  after the deadline it had when it was picked, it is a miss.
+ *  Cancelling a queued task (destroying it) rebuilds the heap — O(n).
+ *  Same ownership and threading rules as Scheduler.
+ * *******************************************************************
+*/
+template<class Policy, class Wheel = default_timer_wheel>
+class EdfScheduler : public BasicScheduler<EdfScheduler<Policy, Wheel>, Policy> {
+    using base_t = BasicScheduler<EdfScheduler<Policy, Wheel>, Policy>;
+    friend base_t;
+
+public:
+    using link_t = ReadyLink<Policy>;
+
+    explicit EdfScheduler(Wheel& clock = timer_wheel) noexcept : wheel(clock) {}
+
+    // attach task without a deadline (it may set one itself)
+    template<class T>
+    bool spawn(Task<T, Policy>& task) noexcept {
+        return attach_task(task, 0, 0);
+    }
+
+    // attach task with an absolute first deadline
+    template<class T>
+    bool spawn(Task<T, Policy>& task, tick_t deadline) noexcept {
+        return attach_task(task, deadline, sched_has_deadline);
+    }
+
+    std::size_t ready_count() const noexcept { return ready_total; }
+
+    // activations (runs ending in block / finish) that had a deadline, and how many ended late
+    std::size_t activations() const noexcept { return completed; }
+    std::size_t deadline_misses() const noexcept { return misses; }
+    void reset_counters() noexcept { completed = misses = 0; }
+
+private:
+    template<class T>
+    bool attach_task(Task<T, Policy>& task, tick_t deadline, std::uint8_t flags) noexcept {
+        link_t* link = base_t::claim(task);
+        if (link == nullptr) {
+            return false;
+        }
+        link->sched_key = deadline;
+        link->sched_flags = static_cast<std::uint8_t>(flags | sched_deadline_sink);
+        this->attach(*link);
+        return true;
+    }
+
+    static bool has_deadline(const link_t& link) noexcept {
+        return (link.sched_flags & sched_has_deadline) != 0;
+    }
+
+    static bool earlier(const link_t& a, const link_t& b) noexcept {
+        return static_cast<std::int32_t>(a.sched_key - b.sched_key) < 0;
+    }
+
+    static link_t* as_link(ReadyHook* hook) noexcept { return static_cast<link_t*>(hook); }
+
+    // pairing heap: a and b are roots, returns the new root (its sibling is left to the caller)
+    link_t* meld(link_t* a, link_t* b) noexcept {
+        if (a == nullptr) {
+            return b;
+        }
+        if (b == nullptr) {
+            return a;
+        }
+        if (earlier(*b, *a)) {
+            std::swap(a, b);
+        }
+        b->next = a->prev ? a->prev : &end;
+        a->prev = b;
+        return a;
+    }
+
+    // two-pass merge of a sibling list ending at &end
+    link_t* merge_pairs(ReadyHook* first) noexcept {
+        link_t* pairs = nullptr;
+        ReadyHook* cur = first;
+        while (cur != nullptr && cur != &end) {
+            link_t* a = as_link(cur);
+            link_t* b = a->next != &end ? as_link(a->next) : nullptr;
+            cur = b ? b->next : &end;
+            a->next = nullptr;
+            if (b) {
+                b->next = nullptr;
+            }
+            link_t* m = meld(a, b);
+            m->next = pairs;
+            pairs = m;
+        }
+
+        link_t* result = nullptr;
+        while (pairs != nullptr) {
+            link_t* next = as_link(pairs->next);
+            pairs->next = nullptr;
+            result = meld(result, pairs);
+            pairs = next;
+        }
+        return result;
+    }
+
+    void heap_push(link_t& link) noexcept {
+        link.prev = nullptr;
+        link.next = &end;
+        root = meld(root, &link);
+        root->next = &end;
+    }
+
+    link_t* heap_pop() noexcept {
+        link_t* top = root;
+        if (top == nullptr) {
+            return nullptr;
+        }
+        root = merge_pairs(top->prev);
+        if (root) {
+            root->next = &end;
+        }
+        top->next = top->prev = nullptr;
+        return top;
+    }
+
+    void push(link_t& link) noexcept {
+        if (has_deadline(link)) {
+            heap_push(link);
+        } else {
+            background.push(link);
+        }
+        ++ready_total;
+    }
+
+    link_t* pop_next() noexcept {
+        link_t* link = heap_pop();
+        if (link == nullptr) {
+            link = background.pop();
+        }
+        if (link != nullptr) {
+            --ready_total;
+        }
+        return link;
+    }
+
+    // linked() links only
+    void remove(link_t& link) noexcept {
+        if (!has_deadline(link)) {
+            background.remove(link);
+        } else {
+            // rare (task destroyed while queued): pop everything but `link`, push back
+            link_t* keep = nullptr;
+            while (link_t* n = heap_pop()) {
+                if (n != &link) {
+                    n->next = keep;
+                    keep = n;
+                }
+            }
+            while (keep != nullptr) {
+                link_t* next = as_link(keep->next);
+                heap_push(*keep);
+                keep = next;
+            }
+        }
+        --ready_total;
+    }
+
+    // one activation: a timed run that ends in block / finish is checked against its deadline
+    void run_link(link_t& link) noexcept {
+        const bool timed = has_deadline(link);
+        const tick_t deadline = link.sched_key;
+
+        PromiseCore<Policy>::from_link(link).run(link.handle);
+
+        if (timed && (link.handle.done() || static_cast<BlockingMixin<Policy>&>(link).is_blocked())) {
+            ++completed;
+            if (static_cast<std::int32_t>(wheel.now() - deadline) > 0) {
+                ++misses;
+            }
+        }
+    }
+
+    Wheel& wheel;
+    ReadyHook end{};                // sibling-list terminator, keeps linked() true inside the heap
+    link_t* root = nullptr;
+    ReadyQueue<Policy> background{};
+    std::size_t ready_total = 0;
+    std::size_t completed = 0;
+    std::size_t misses = 0;
+};
+
+} /* namespace ucoro */
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_EDF_H
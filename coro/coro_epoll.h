@@ -0,0 +1,307 @@
+#ifndef CORO_EPOLL_H
+#define CORO_EPOLL_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+#if defined(__linux__)
+
+#include "coro_promise.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace ucoro {
+
+// one task waiting for one direction of one fd; lives inside the awaitable (coroutine frame)
+struct IoWaiter {
+    Waker waker{};
+    int fd = -1;
+    std::uint32_t interest = 0;     // EPOLLIN or EPOLLOUT
+    bool ready = false;             // false: fd could not be watched
+};
+
+/*
+ * *******************************************************************
+ *  EpollReactor:
+ *  file-descriptor readiness for Tasks on Linux (sockets, pipes,
+ *  timerfd, serial ports). A dense table of MaxFds slots holds at
+ *  most one reader and one writer per fd; fds are registered
+ *  EPOLLONESHOT, so a wait costs one epoll_ctl and only the tasks
+ *  that wait are ever woken. poll() collects up to Batch events with
+ *  one epoll_wait() and unblocks exactly the matching waiters.
+ *  Also an idle source for TicklessLoop: the loop sleeps inside
+ *  epoll_wait(); notify() (an eventfd) wakes it from other contexts.
+ *  NOTE: single context — readable()/writable()/poll() from the thread
+ *  that runs the scheduler; notify() from anywhere.
+ *
+ *  ucoro::Scheduler<ucoro::PlainPolicy> sched;
+ *  ucoro::TicklessLoop loop(sched, ucoro::epoll_reactor());
+ *  ...
+ *  while (co_await ucoro::readable(sock)) {
+ *      n = read(sock, buf, sizeof(buf));
+ *  }
+ * *******************************************************************
+*/
+template<std::size_t MaxFds = 1024, std::size_t Batch = 64>
+class EpollReactor {
+    static_assert(MaxFds > 0 && Batch > 0, "[UCORO]: empty epoll reactor");
+
+public:
+    EpollReactor() noexcept {
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        wakefd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (epfd >= 0 && wakefd >= 0) {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = wakefd;
+            epoll_ctl(epfd, EPOLL_CTL_ADD, wakefd, &ev);
+        }
+    }
+
+    EpollReactor(const EpollReactor&) = delete;
+    EpollReactor& operator=(const EpollReactor&) = delete;
+
+    // destroy the tasks waiting on it first
+    ~EpollReactor() {
+        if (wakefd >= 0) {
+            close(wakefd);
+        }
+        if (epfd >= 0) {
+            close(epfd);
+        }
+    }
+
+    bool valid() const noexcept { return epfd >= 0 && wakefd >= 0; }
+    std::size_t waiting() const noexcept { return waiters; }
+
+    // start watching for waiter.interest; false: fd out of range, direction taken, or epoll refused it
+    bool arm(IoWaiter& waiter) noexcept {
+        if (!valid() || waiter.fd < 0 || static_cast<std::size_t>(waiter.fd) >= MaxFds) {
+            return false;
+        }
+        Slot& slot = slots[static_cast<std::size_t>(waiter.fd)];
+        IoWaiter*& place = waiter.interest == EPOLLIN ? slot.reader : slot.writer;
+        if (place != nullptr) {
+            return false;
+        }
+
+        place = &waiter;
+        if (!update(waiter.fd, slot)) {
+            place = nullptr;
+            return false;
+        }
+        ++waiters;
+        return true;
+    }
+
+    // waiter gone before its fd became ready (frame destroyed)
+    void disarm(IoWaiter& waiter) noexcept {
+        if (waiter.fd < 0 || static_cast<std::size_t>(waiter.fd) >= MaxFds) {
+            return;
+        }
+        Slot& slot = slots[static_cast<std::size_t>(waiter.fd)];
+        IoWaiter*& place = waiter.interest == EPOLLIN ? slot.reader : slot.writer;
+        if (place == &waiter) {
+            place = nullptr;
+            --waiters;
+            update(waiter.fd, slot);    // keep only the other direction armed
+        }
+    }
+
+    // one epoll_wait(): unblocks the waiters of ready fds, returns how many; timeout_ms < 0 — no limit
+    std::size_t poll(int timeout_ms = 0) noexcept {
+        if (!valid()) {
+            return 0;
+        }
+        epoll_event events[Batch];
+        const int n = epoll_wait(epfd, events, static_cast<int>(Batch), timeout_ms);
+
+        std::size_t woken = 0;
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == wakefd) {
+                std::uint64_t drained;
+                (void)!read(wakefd, &drained, sizeof(drained));
+                continue;
+            }
+
+            Slot& slot = slots[static_cast<std::size_t>(fd)];
+            const std::uint32_t got = events[i].events;
+            const bool failed = (got & (EPOLLERR | EPOLLHUP)) != 0;
+            slot.armed = 0;     // one-shot: disarmed by the kernel
+
+            if (slot.reader != nullptr && (failed || (got & (EPOLLIN | EPOLLRDHUP)) != 0)) {
+                woken += wake(slot.reader);
+            }
+            if (slot.writer != nullptr && (failed || (got & EPOLLOUT) != 0)) {
+                woken += wake(slot.writer);
+            }
+            if (slot.reader != nullptr || slot.writer != nullptr) {
+                update(fd, slot);       // the other direction still waits
+            }
+        }
+        return woken;
+    }
+
+    /*
+     * idle source interface (see IdleSignal / TicklessLoop)
+     */
+    void notify() noexcept {
+        word.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) != 0) {
+            const std::uint64_t one = 1;
+            (void)!write(wakefd, &one, sizeof(one));
+        }
+    }
+
+    Waker waker() noexcept { return Waker{&EpollReactor::on_wake, this}; }
+
+    std::uint32_t prepare() noexcept {
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        return word.load(std::memory_order_seq_cst);
+    }
+
+    // sleeps in epoll_wait(), rounded up to whole milliseconds so the deadline is not missed
+    void wait(std::uint32_t seen, std::int64_t timeout_ns) noexcept {
+        if (word.load(std::memory_order_seq_cst) != seen) {
+            return;
+        }
+        int timeout_ms = -1;
+        if (timeout_ns >= 0) {
+            const std::int64_t ms = (timeout_ns + 999999) / 1000000;
+            timeout_ms = ms > 0x7FFFFFFF ? 0x7FFFFFFF : static_cast<int>(ms);
+        }
+        poll(timeout_ms);
+    }
+
+    void finish() noexcept { sleepers.fetch_sub(1, std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        IoWaiter* reader = nullptr;
+        IoWaiter* writer = nullptr;
+        std::uint32_t armed = 0;        // events currently armed in epoll
+        bool added = false;             // fd is known to epoll
+    };
+
+    static void on_wake(void* self) noexcept { static_cast<EpollReactor*>(self)->notify(); }
+
+    std::size_t wake(IoWaiter*& place) noexcept {
+        IoWaiter& waiter = *place;
+        place = nullptr;
+        --waiters;
+        waiter.ready = true;
+        waiter.waker();
+        return 1;
+    }
+
+    // (re)arm the fd for the directions that still have a waiter
+    bool update(int fd, Slot& slot) noexcept {
+        const std::uint32_t want = (slot.reader ? std::uint32_t(EPOLLIN | EPOLLRDHUP) : 0u)
+                                 | (slot.writer ? std::uint32_t(EPOLLOUT) : 0u);
+        if (want == slot.armed) {
+            return true;
+        }
+
+        epoll_event ev{};
+        ev.events = want | EPOLLONESHOT;
+        ev.data.fd = fd;
+        // an fd closed and reused behind our back: MOD says ENOENT, ADD says EEXIST — try the other one
+        int op = slot.added ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+        if (epoll_ctl(epfd, op, fd, &ev) != 0) {
+            op = errno == ENOENT ? EPOLL_CTL_ADD : errno == EEXIST ? EPOLL_CTL_MOD : -1;
+            if (op < 0 || epoll_ctl(epfd, op, fd, &ev) != 0) {
+                slot.added = false;
+                slot.armed = 0;
+                return false;
+            }
+        }
+        slot.added = true;
+        slot.armed = want;      // want == 0: stays registered but disarmed
+        return true;
+    }
+
+    int epfd = -1;
+    int wakefd = -1;
+    std::size_t waiters = 0;
+    Slot slots[MaxFds]{};
+    std::atomic<std::uint32_t> word{0};
+    std::atomic<std::uint32_t> sleepers{0};
+};
+
+using default_epoll_reactor = EpollReactor<>;
+
+// global reactor used by readable() / writable() without an explicit reactor;
+// created on first use, so including the header opens no epoll / eventfd descriptors
+inline default_epoll_reactor& epoll_reactor() noexcept {
+    static default_epoll_reactor reactor;
+    return reactor;
+}
+
+/*
+ * *******************************************************************
+ *  IoAwaitable:
+ *  parks the task (block()) until its fd is ready in one direction.
+ *  co_await returns true when ready (or hung up / error — the next
+ *  read / write tells which), false when the fd cannot be watched.
+ *  Destroying the frame while waiting disarms it.
+ * *******************************************************************
+*/
+template<class Reactor>
+struct IoAwaitable : private IoWaiter {
+    Reactor& reactor;
+
+    IoAwaitable(Reactor& r, int fd_, std::uint32_t direction) noexcept : reactor(r) {
+        fd = fd_;
+        interest = direction;
+    }
+    IoAwaitable(const IoAwaitable&) = delete;
+    IoAwaitable& operator=(const IoAwaitable&) = delete;
+
+    ~IoAwaitable() { reactor.disarm(*this); }
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    template<class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        static_assert(Promise::policy_t::use_blocking, "You must use blocking type Task");
+
+        waker = Waker::of(h.promise());
+        if (!reactor.arm(*this)) {
+            ready = false;
+            return false;
+        }
+        h.promise().block();    // readiness is only dispatched by poll(), i.e. after we suspend
+        return true;
+    }
+
+    bool await_resume() const noexcept { return ready; }
+};
+
+template<class Reactor>
+IoAwaitable<Reactor> readable(Reactor& reactor, int fd) noexcept {
+    return {reactor, fd, EPOLLIN};
+}
+
+template<class Reactor>
+IoAwaitable<Reactor> writable(Reactor& reactor, int fd) noexcept {
+    return {reactor, fd, EPOLLOUT};
+}
+
+inline IoAwaitable<default_epoll_reactor> readable(int fd) noexcept {
+    return {epoll_reactor(), fd, EPOLLIN};
+}
+
+inline IoAwaitable<default_epoll_reactor> writable(int fd) noexcept {
+    return {epoll_reactor(), fd, EPOLLOUT};
+}
+
+} /* namespace ucoro */
+
+#endif /* __linux__ */
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_EPOLL_H
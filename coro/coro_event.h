@@ -2,11 +2,15 @@
 #define CORO_EVENT_H
 
 #include "u_coro.h"
+#include "coro_timer.h"
 
 #if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
-#include <functional>
+#include <array>
+#include <bit>
+#include <cstdint>
 
-// Перелік можливих подій
+// Перелік подій глобального event_controller (приклад / сумісність).
+// Застосунок визначає власні переліки і власні BasicEventController<...>, не змінюючи бібліотеку
 enum class EventType {
     TIMER1,
     UART_RX,
@@ -16,80 +20,519 @@ enum class EventType {
 };
 
 
-template <EventType E>
-struct EventAwaitable;
+// Вузол очікувача: живе всередині awaitable (тобто в кадрі корутини), без алокацій
+struct EventWaiter {
+    EventWaiter* next = nullptr;
+    EventWaiter* prev = nullptr;
+    // викликається контролером після того, як вузол вже вилучено зі списку
+    void (*notify)(EventWaiter&) noexcept = nullptr;
+
+    bool linked() const noexcept { return prev != nullptr; }
+};
+
+// Очікувач набору подій (wait_any / wait_all): одна реєстрація на весь набір
+struct EventMaskWaiter : EventWaiter {
+    std::uint64_t want = 0;     // біти подій набору
+    std::uint64_t got = 0;      // біти, що вже надійшли
+    bool all = false;           // false — будь-яка з подій, true — усі
+};
 
-// Глобальний контролер подій
-class EventController {
+template <class Controller, typename Controller::event_type E>
+struct BasicEventAwaitable;
+
+template <class Controller, typename Controller::event_type E, class Wheel>
+struct BasicTimedEventAwaitable;
+
+template <class Controller>
+struct BasicEventMaskAwaitable;
+
+/*
+ * Контролер подій для переліку Event зі значеннями 0..Count-1
+ * (Count за замовчуванням — Event::COUNT). Таблиці щільні й мають розмір,
+ * відомий під час компіляції; кожен контролер незалежний, тож підсистеми
+ * (або ядра) можуть мати власні замість одного спільного глобального об'єкта.
+ *
+ *  enum class NetEvent { LINK_UP, RX, TX_DONE, COUNT };
+ *  inline BasicEventController<NetEvent> net_events;
+ *  co_await net_events.wait<NetEvent::RX>();
+ *  void eth_isr() { net_events.post<NetEvent::RX>(); }
+ */
+template <class Event, std::size_t Count = static_cast<std::size_t>(Event::COUNT)>
+class BasicEventController {
 public:
+    using event_type = Event;
 
-    static constexpr std::size_t EVENT_COUNT = static_cast<std::size_t>(EventType::COUNT);
+    static constexpr std::size_t EVENT_COUNT = Count;
 
-    // Реєструє обробник для певної події
-    template <EventType E>
-    void subscribe(std::function<void()> callback) noexcept {
-        callbacks[static_cast<std::size_t>(E)] = std::move(callback);
+    BasicEventController() noexcept {
+        for (auto& head : waiters) {
+            head.next = head.prev = &head;
+        }
+        mask_waiters.next = mask_waiters.prev = &mask_waiters;
     }
+    BasicEventController(const BasicEventController&) = delete;
+    BasicEventController& operator=(const BasicEventController&) = delete;
 
-    // Встановлює подію як таку, що відбулася, і викликає її обробник
-    template <EventType E>
+    // Додає очікувача в кінець черги події
+    template <Event E>
+    void subscribe(EventWaiter& waiter) noexcept {
+        link_tail(waiters[index<E>()], waiter);
+    }
+
+    // Прибирає очікувача (безпечно, якщо він вже не в черзі)
+    static void unsubscribe(EventWaiter& waiter) noexcept {
+        if (waiter.linked()) {
+            unlink(waiter);
+        }
+    }
+
+    // Додає очікувача набору подій (waiter.want) в кінець спільної черги
+    void subscribe_mask(EventMaskWaiter& waiter) noexcept {
+        link_tail(mask_waiters, waiter);
+    }
+
+    // Будить усіх очікувачів; якщо їх немає — подія запам'ятовується (latched)
+    template <Event E>
     void pend() noexcept {
-        constexpr auto index = static_cast<std::size_t>(E);
-        if (callbacks[index]) {
-            callbacks[index]();
-            clear_callback<E>();
+        pend_mask(bit<E>());
+    }
+
+    // Біт події E / маска набору подій (для результату wait_any / wait_all)
+    template <Event E>
+    static constexpr std::uint64_t bit() noexcept {
+        return std::uint64_t(1) << index<E>();
+    }
+
+    template <Event... Es>
+    static constexpr std::uint64_t mask() noexcept {
+        return (std::uint64_t(0) | ... | bit<Es>());
+    }
+
+
+    // ISR / signal-safe: лише атомарно виставляє біт події, без блокувань і алокацій.
+    // Очікувачі будяться пізніше, у dispatch_posted() з основного контексту
+    template <Event E>
+    void post() noexcept {
+        UCORO_TRACE_RECORD(EventPost, nullptr, index<E>());
+        posted_mask.fetch_or(mask_t(1) << index<E>(), std::memory_order_release);
+        if (post_hook) {
+            post_hook();
+        }
+    }
+
+    // Викликається після кожного post() (напр. IdleSignal::waker() — розбудити сплячий цикл).
+    // Встановлювати до того, як почнуться post(); сам хук має бути ISR / signal-safe
+    void set_post_hook(ucoro::Waker hook) noexcept {
+        post_hook = hook;
+    }
+
+    // Чи є опубліковані, але ще не оброблені dispatch_posted() події
+    bool has_posted() const noexcept {
+        return posted_mask.load(std::memory_order_acquire) != 0;
+    }
+
+    // Основний контекст (перед Scheduler::run_once()): pend() для всіх опублікованих подій разом.
+    // Повертає маску оброблених подій
+    std::uint64_t dispatch_posted() noexcept {
+        const std::uint64_t mask = posted_mask.exchange(0, std::memory_order_acquire);
+        if (mask != 0) {
+            pend_mask(mask);
         }
+        return mask;
+    }
+
+    // Будить лише першого очікувача (FIFO); якщо їх немає — подія запам'ятовується
+    template <Event E>
+    void pend_one() noexcept {
+        UCORO_TRACE_RECORD(EventPend, nullptr, index<E>());
+        EventWaiter& head = waiters[index<E>()];
+        if (head.next != &head) {
+            EventWaiter* node = head.next;
+            unlink(*node);
+            node->notify(*node);
+            return;
+        }
+
+        // далі — перший очікувач набору, що містить подію
+        for (EventWaiter* node = mask_waiters.next; node != &mask_waiters; node = node->next) {
+            auto& waiter = static_cast<EventMaskWaiter&>(*node);
+            if (waiter.want & bit<E>()) {
+                waiter.got |= bit<E>();
+                if (satisfied(waiter)) {
+                    unlink(waiter);
+                    waiter.notify(waiter);
+                }
+                return;
+            }
+        }
+        latched = static_cast<mask_t>(latched | bit<E>());
     }
 
     // Перевіряє, чи подія в стані очікування
-    template <EventType E>
+    template <Event E>
     bool is_pending() const noexcept {
-        return pending_flags[static_cast<std::size_t>(E)];
+        return (latched & bit<E>()) != 0;
+    }
+
+    // Забирає запам'ятовану подію: true, якщо вона була
+    template <Event E>
+    bool consume() noexcept {
+        return consume_mask(bit<E>()) != 0;
     }
 
-    // Очищає обробник для певної події
-    template <EventType E>
-    void clear_callback() noexcept {
-        callbacks[static_cast<std::size_t>(E)] = nullptr;
+    // Забирає всі запам'ятовані події з маски, повертає ті, що були
+    std::uint64_t consume_mask(std::uint64_t mask) noexcept {
+        const auto taken = static_cast<mask_t>(latched & mask);
+        latched = static_cast<mask_t>(latched & ~taken);
+        return taken;
     }
 
+    // Скидає запам'ятовану подію
+    template <Event E>
+    void clear() noexcept {
+        latched = static_cast<mask_t>(latched & ~bit<E>());
+    }
+
+    // Чи хтось чекає на подію (окремо або в наборі)
+    template <Event E>
+    bool has_waiters() const noexcept {
+        const EventWaiter& head = waiters[index<E>()];
+        if (head.next != &head) {
+            return true;
+        }
+        for (const EventWaiter* node = mask_waiters.next; node != &mask_waiters; node = node->next) {
+            if (static_cast<const EventMaskWaiter&>(*node).want & bit<E>()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // co_await wait<E>() — чекати на подію цього контролера
+    template <Event E>
+    BasicEventAwaitable<BasicEventController, E> wait() noexcept;
+
+    // co_await wait_until<E>(tick) / wait_for<E>(ticks): true — подія, false — тайм-аут
+    template <Event E, class Wheel = ucoro::default_timer_wheel>
+    BasicTimedEventAwaitable<BasicEventController, E, Wheel> wait_until(ucoro::tick_t deadline,
+                                                                        Wheel& wheel = ucoro::timer_wheel) noexcept;
+
+    template <Event E, class Wheel = ucoro::default_timer_wheel>
+    BasicTimedEventAwaitable<BasicEventController, E, Wheel> wait_for(ucoro::tick_t timeout,
+                                                                      Wheel& wheel = ucoro::timer_wheel) noexcept;
+
+    // co_await wait_any<E1, E2...>() — будь-яка з подій; wait_all<...>() — усі.
+    // Повертає маску подій, що надійшли (перевіряти через bit<E>())
+    template <Event... Es>
+    BasicEventMaskAwaitable<BasicEventController> wait_any() noexcept;
+
+    template <Event... Es>
+    BasicEventMaskAwaitable<BasicEventController> wait_all() noexcept;
+
 private:
-    // Масив для зберігання обробників подій
-    std::array<std::function<void()>, EVENT_COUNT> callbacks{};
-    // Масив для позначення стану подій (чи відбулися)
-    std::array<bool, EVENT_COUNT> pending_flags{};
-};
+    template <Event E>
+    static constexpr std::size_t index() noexcept {
+        static_assert(static_cast<std::size_t>(E) < EVENT_COUNT, "Event out of range");
+        return static_cast<std::size_t>(E);
+    }
 
-// Глобальний екземпляр контролера подій
-inline EventController event_controller;
+    static bool satisfied(const EventMaskWaiter& waiter) noexcept {
+        return waiter.all ? waiter.got == waiter.want : waiter.got != 0;
+    }
+
+    // pend() для кожної події маски: окремі очікувачі — по списку на подію,
+    // очікувачі наборів — один прохід для всієї маски (по одному AND на очікувача)
+    void pend_mask(std::uint64_t mask) noexcept {
+        std::uint64_t taken = 0;
+        for (std::uint64_t rest = mask; rest != 0; rest &= rest - 1) {
+            const auto i = static_cast<std::size_t>(std::countr_zero(rest));
+            UCORO_TRACE_RECORD(EventPend, nullptr, i);
+            if (wake_all(waiters[i])) {
+                taken |= std::uint64_t(1) << i;
+            }
+        }
+
+        if (mask_waiters.next != &mask_waiters) {
+            // від'єднуємо весь список, щоб notify() міг безпечно підписатися знову
+            EventWaiter* node = mask_waiters.next;
+            mask_waiters.prev->next = nullptr;
+            mask_waiters.next = mask_waiters.prev = &mask_waiters;
+
+            while (node != nullptr) {
+                EventWaiter* next = node->next;
+                auto& waiter = static_cast<EventMaskWaiter&>(*node);
+                const std::uint64_t hit = waiter.want & mask;
+                taken |= hit;
+                waiter.got |= hit;
+                node->next = node->prev = nullptr;
+                if (hit != 0 && satisfied(waiter)) {
+                    waiter.notify(waiter);
+                } else {
+                    link_tail(mask_waiters, waiter);
+                }
+                node = next;
+            }
+        }
+
+        latched = static_cast<mask_t>(latched | (mask & ~taken));
+    }
+
+    // будить увесь список; false — він був порожній
+    static bool wake_all(EventWaiter& head) noexcept {
+        if (head.next == &head) {
+            return false;
+        }
+
+        // від'єднуємо весь список, щоб notify() міг безпечно підписатися знову
+        EventWaiter* node = head.next;
+        head.prev->next = nullptr;
+        head.next = head.prev = &head;
+
+        while (node != nullptr) {
+            EventWaiter* next = node->next;
+            node->next = node->prev = nullptr;
+            node->notify(*node);
+            node = next;
+        }
+        return true;
+    }
+
+    static void link_tail(EventWaiter& head, EventWaiter& waiter) noexcept {
+        waiter.prev = head.prev;
+        waiter.next = &head;
+        head.prev->next = &waiter;
+        head.prev = &waiter;
+    }
+
+    static void unlink(EventWaiter& waiter) noexcept {
+        waiter.prev->next = waiter.next;
+        waiter.next->prev = waiter.prev;
+        waiter.next = waiter.prev = nullptr;
+    }
+
+    static_assert(EVENT_COUNT > 0, "Event set is empty");
+
+    static_assert(EVENT_COUNT <= 64, "more than 64 events do not fit the event masks");
+    using mask_t = std::conditional_t<(EVENT_COUNT <= 32), std::uint32_t, std::uint64_t>;
+
+    // Голови інтрузивних списків очікувачів (кільцеві, з вартовим вузлом)
+    std::array<EventWaiter, EVENT_COUNT> waiters{};
+    // Очікувачі наборів подій (EventMaskWaiter), один список на весь контролер
+    EventWaiter mask_waiters{};
+    // Маска подій, що відбулися без очікувачів (latched)
+    mask_t latched = 0;
+
+    // Події, опубліковані з переривань/сигналів/інших потоків і ще не оброблені
+    ucoro::AtomicPolicy::block_t<mask_t> posted_mask{0};
+    static_assert(decltype(posted_mask)::is_always_lock_free, "post() needs a lock-free atomic mask");
+
+    // Хук після post(), порожній за замовчуванням
+    ucoro::Waker post_hook{};
+};
 
 // Awaiter для асинхронного очікування подій
-template <EventType E>
-struct EventAwaitable {
-    bool await_ready() const noexcept {
-        return event_controller.is_pending<E>();
+template <class Controller, typename Controller::event_type E>
+struct BasicEventAwaitable : private EventWaiter {
+    Controller& controller;
+    ucoro::Waker waker{};
+
+    explicit BasicEventAwaitable(Controller& c) noexcept : controller(c) {}
+    BasicEventAwaitable(const BasicEventAwaitable&) = delete;
+    BasicEventAwaitable& operator=(const BasicEventAwaitable&) = delete;
+
+    // кадр знищено під час очікування — виходимо з черги
+    ~BasicEventAwaitable() { Controller::unsubscribe(*this); }
+
+    // подія вже відбулася — не призупиняємося взагалі
+    bool await_ready() noexcept {
+        return controller.template consume<E>();
     }
 
     template<class Promise>
     void await_suspend(std::coroutine_handle<Promise> h) noexcept {
         static_assert(Promise::policy_t::use_blocking, "You must use blocking type Task");
 
-        auto& promise = h.promise();
-        promise.block();
+        h.promise().block();
+        waker = ucoro::Waker::of(h.promise());
+        notify = &BasicEventAwaitable::on_event;
+        controller.template subscribe<E>(*this);
+    }
 
-        Promise::task_t task;
+    void await_resume() const noexcept {}
 
-        event_controller.subscribe<E>([&]() mutable {
-            promise.unblock();
-        });
+private:
+    static void on_event(EventWaiter& waiter) noexcept {
+        static_cast<BasicEventAwaitable&>(waiter).waker();
     }
+};
 
-    void await_resume() const noexcept {}
+// Awaiter події з тайм-аутом: co_await повертає true — подія, false — тайм-аут
+template <class Controller, typename Controller::event_type E, class Wheel>
+struct BasicTimedEventAwaitable : private EventWaiter, private ucoro::TimerNode {
+    Controller& controller;
+    Wheel& wheel;
+    ucoro::tick_t deadline;
+    ucoro::Waker waker{};
+    bool fired = false;
+
+    BasicTimedEventAwaitable(Controller& c, Wheel& w, ucoro::tick_t until) noexcept
+        : controller(c), wheel(w), deadline(until) {}
+    BasicTimedEventAwaitable(const BasicTimedEventAwaitable&) = delete;
+    BasicTimedEventAwaitable& operator=(const BasicTimedEventAwaitable&) = delete;
+
+    ~BasicTimedEventAwaitable() {
+        wheel.cancel(*this);
+        Controller::unsubscribe(*this);
+    }
+
+    bool await_ready() noexcept {
+        fired = controller.template consume<E>();
+        return fired;
+    }
+
+    template<class Promise>
+    void await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        static_assert(Promise::policy_t::use_blocking, "You must use blocking type Task");
+
+        h.promise().block();
+        waker = ucoro::Waker::of(h.promise());
+
+        EventWaiter::notify = &BasicTimedEventAwaitable::on_event;
+        controller.template subscribe<E>(*this);
+
+        ucoro::TimerNode::fire = &BasicTimedEventAwaitable::on_timeout;
+        wheel.schedule(*this, deadline);
+    }
+
+    bool await_resume() const noexcept { return fired; }
+
+private:
+    static void on_event(EventWaiter& waiter) noexcept {
+        auto& self = static_cast<BasicTimedEventAwaitable&>(waiter);
+        self.fired = true;
+        self.wheel.cancel(self);
+        self.waker();
+    }
+
+    static void on_timeout(ucoro::TimerNode& node) noexcept {
+        auto& self = static_cast<BasicTimedEventAwaitable&>(node);
+        Controller::unsubscribe(self);
+        self.waker();
+    }
+};
+
+template <class Event, std::size_t Count>
+template <Event E>
+BasicEventAwaitable<BasicEventController<Event, Count>, E> BasicEventController<Event, Count>::wait() noexcept {
+    return BasicEventAwaitable<BasicEventController, E>{*this};
+}
+
+template <class Event, std::size_t Count>
+template <Event E, class Wheel>
+BasicTimedEventAwaitable<BasicEventController<Event, Count>, E, Wheel>
+BasicEventController<Event, Count>::wait_until(ucoro::tick_t deadline, Wheel& wheel) noexcept {
+    return {*this, wheel, deadline};
+}
+
+template <class Event, std::size_t Count>
+template <Event E, class Wheel>
+BasicTimedEventAwaitable<BasicEventController<Event, Count>, E, Wheel>
+BasicEventController<Event, Count>::wait_for(ucoro::tick_t timeout, Wheel& wheel) noexcept {
+    return {*this, wheel, wheel.now() + timeout};
+}
+
+// Awaiter набору подій: реєструється один раз на весь набір, повертає маску подій, що надійшли.
+// wait_all: події, що надійшли раніше за інші, запам'ятовуються в got (знищення кадру їх втрачає)
+template <class Controller>
+struct BasicEventMaskAwaitable : private EventMaskWaiter {
+    Controller& controller;
+    ucoro::Waker waker{};
+
+    BasicEventMaskAwaitable(Controller& c, std::uint64_t events, bool every) noexcept : controller(c) {
+        want = events;
+        all = every;
+    }
+    BasicEventMaskAwaitable(const BasicEventMaskAwaitable&) = delete;
+    BasicEventMaskAwaitable& operator=(const BasicEventMaskAwaitable&) = delete;
+
+    ~BasicEventMaskAwaitable() { Controller::unsubscribe(*this); }
+
+    // запам'ятовані події з набору забираються одразу
+    bool await_ready() noexcept {
+        got = controller.consume_mask(want);
+        return all ? got == want : got != 0;
+    }
+
+    template<class Promise>
+    void await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        static_assert(Promise::policy_t::use_blocking, "You must use blocking type Task");
+
+        h.promise().block();
+        waker = ucoro::Waker::of(h.promise());
+        notify = &BasicEventMaskAwaitable::on_event;
+        controller.subscribe_mask(*this);
+    }
+
+    std::uint64_t await_resume() const noexcept { return got; }
+
+private:
+    static void on_event(EventWaiter& waiter) noexcept {
+        static_cast<BasicEventMaskAwaitable&>(waiter).waker();
+    }
 };
 
+template <class Event, std::size_t Count>
+template <Event... Es>
+BasicEventMaskAwaitable<BasicEventController<Event, Count>> BasicEventController<Event, Count>::wait_any() noexcept {
+    static_assert(sizeof...(Es) > 0, "wait_any() needs at least one event");
+    return {*this, mask<Es...>(), false};
+}
+
+template <class Event, std::size_t Count>
+template <Event... Es>
+BasicEventMaskAwaitable<BasicEventController<Event, Count>> BasicEventController<Event, Count>::wait_all() noexcept {
+    static_assert(sizeof...(Es) > 0, "wait_all() needs at least one event");
+    return {*this, mask<Es...>(), true};
+}
+
+/*
+ * Сумісність: контролер над EventType, глобальний екземпляр і старі імена
+ */
+using EventController = BasicEventController<EventType>;
+
+// Глобальний екземпляр контролера подій
+inline EventController event_controller;
+
+template <EventType E>
+using EventAwaitable = BasicEventAwaitable<EventController, E>;
+
+template <EventType E, class Wheel = ucoro::default_timer_wheel>
+using TimedEventAwaitable = BasicTimedEventAwaitable<EventController, E, Wheel>;
+
 template<EventType I>
 EventAwaitable<I> make_interrupt_awaiter() noexcept {
-    return {};
+    return EventAwaitable<I>{event_controller};
+}
+
+// co_await wait_any<EventType::UART_RX, EventType::TIMER1>() на глобальному контролері
+template<EventType... Es>
+BasicEventMaskAwaitable<EventController> wait_any() noexcept {
+    return event_controller.wait_any<Es...>();
+}
+
+template<EventType... Es>
+BasicEventMaskAwaitable<EventController> wait_all() noexcept {
+    return event_controller.wait_all<Es...>();
+}
+
+template<EventType I>
+TimedEventAwaitable<I> make_interrupt_awaiter_until(ucoro::tick_t deadline) noexcept {
+    return {event_controller, ucoro::timer_wheel, deadline};
+}
+
+template<EventType I>
+TimedEventAwaitable<I> make_interrupt_awaiter_for(ucoro::tick_t timeout) noexcept {
+    return {event_controller, ucoro::timer_wheel, ucoro::timer_wheel.now() + timeout};
 }
 
 #endif /* **********************UCORO_ENABLED*************************** */
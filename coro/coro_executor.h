@@ -0,0 +1,392 @@
+#ifndef CORO_EXECUTOR_H
+#define CORO_EXECUTOR_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+// <thread> pulls std::this_thread::yield, which clashes with yield() from coro_macro.h
+#pragma push_macro("yield")
+#undef yield
+#include <cstdint>
+#include <memory>
+#include <thread>
+#pragma pop_macro("yield")
+
+#include "coro_scheduler.h"
+
+namespace ucoro {
+
+/*
+ * *******************************************************************
+ *  WorkDeque:
+ *  fixed-capacity Chase-Lev deque of ready links (Le, Pop, Cohen,
+ *  Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak
+ *  Memory Models"). Owner push/pop at the bottom, thieves steal from
+ *  the top. No allocation; push() fails when full.
+ * *******************************************************************
+*/
+template<class Policy, std::size_t Capacity>
+class WorkDeque {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "[UCORO]: WorkDeque capacity must be a power of two");
+
+public:
+    using link_t = ReadyLink<Policy>;
+
+    bool push(link_t& link) noexcept {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= static_cast<std::int64_t>(Capacity)) {
+            return false;
+        }
+        slots[b & mask].store(&link, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    link_t* pop() noexcept {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        link_t* link = slots[b & mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // last element — race against thieves
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                link = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return link;
+    }
+
+    link_t* steal() noexcept {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return nullptr;
+        }
+        link_t* link = slots[t & mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;     // lost the race, caller may retry elsewhere
+        }
+        return link;
+    }
+
+private:
+    static constexpr std::int64_t mask = static_cast<std::int64_t>(Capacity) - 1;
+
+    alignas(64) std::atomic<std::int64_t> top{0};
+    alignas(64) std::atomic<std::int64_t> bottom{0};
+    std::atomic<link_t*> slots[Capacity]{};
+};
+
+/*
+ * *******************************************************************
+ *  WorkStealingExecutor:
+ *  N worker threads, each with its own WorkDeque. A worker runs its
+ *  own deque (LIFO), then the shared MPSC inbox, then steals from the
+ *  others. Blocked tasks are parked exactly like in Scheduler: their
+ *  unblock() (from any thread) pushes them back.
+ *  Tasks stay owned by the caller. Destroying a Task that is not
+ *  running detaches it (a queued one is dropped by the worker that
+ *  takes it); destroying the executor detaches the remaining tasks,
+ *  which are not resumed any more.
+ *  Frames are created/destroyed by the owner thread, so a FramePool
+ *  is fine as long as tasks are spawned and destroyed from one thread.
+ *
+ *  ucoro::WorkStealingExecutor<> ex(std::thread::hardware_concurrency());
+ *  for (auto& t : tasks) { ex.spawn(t); }
+ *  ex.wait();
+ * *******************************************************************
+*/
+template<class Policy = AtomicPolicy, std::size_t DequeCapacity = 1024>
+class WorkStealingExecutor : private ReadySink<Policy> {
+    static_assert(use_scheduler_v<Policy> && Policy::is_atomic,
+                  "[UCORO]: WorkStealingExecutor needs a blocking atomic policy (AtomicPolicy), not Lean");
+
+public:
+    using link_t = ReadyLink<Policy>;
+
+    explicit WorkStealingExecutor(unsigned worker_count)
+        : ReadySink<Policy>{&WorkStealingExecutor::on_notify, &WorkStealingExecutor::on_cancel,
+                            &WorkStealingExecutor::on_attach}
+        , count(worker_count == 0 ? 1 : worker_count)
+        , workers(std::make_unique<Worker[]>(count))
+    {
+        for (unsigned i = 0; i < count; ++i) {
+            workers[i].owner = this;
+            workers[i].index = i;
+            workers[i].thread = std::thread([this, i] { worker_loop(workers[i]); });
+        }
+    }
+
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    ~WorkStealingExecutor() {
+        stopping.store(true, std::memory_order_release);
+        wake_all();
+        for (unsigned i = 0; i < count; ++i) {
+            workers[i].thread.join();
+        }
+
+        // workers are gone: forget queued links, then detach every task still attached
+        for (unsigned i = 0; i < count; ++i) {
+            while (link_t* link = workers[i].deque.pop()) {
+                link->release_schedule();
+            }
+        }
+        while (link_t* link = inbox.pop()) {
+            link->release_schedule();
+        }
+        while (link_t* link = tracked.pop()) {
+            link->sink = nullptr;
+        }
+    }
+
+    // attach task (any thread); returns false if it is invalid, finished or attached elsewhere
+    template<class T>
+    bool spawn(Task<T, Policy>& task) noexcept {
+        if (task.done()) {
+            return false;
+        }
+
+        auto& promise = task.handle().promise();
+        link_t& link = promise;
+        if (link.sink != nullptr) {
+            return false;
+        }
+
+        link.handle = task.handle();
+        on_attach(*this, link);
+        return true;
+    }
+
+    // block the calling (non-worker) thread until every attached task finished
+    void wait() noexcept {
+        std::size_t n = attached.load(std::memory_order_acquire);
+        while (n != 0) {
+            attached.wait(n, std::memory_order_acquire);
+            n = attached.load(std::memory_order_acquire);
+        }
+    }
+
+    std::size_t active() const noexcept { return attached.load(std::memory_order_acquire); }
+    unsigned worker_count() const noexcept { return count; }
+
+private:
+    struct Worker {
+        WorkDeque<Policy, DequeCapacity> deque{};
+        std::thread thread{};
+        WorkStealingExecutor* owner = nullptr;
+        unsigned index = 0;
+    };
+
+    // worker running on this thread — of any executor with this Policy, check owner
+    inline static thread_local Worker* current = nullptr;
+
+    void worker_loop(Worker& self) noexcept {
+        current = &self;
+        unsigned victim = self.index;
+        unsigned misses = 0;
+
+        while (!stopping.load(std::memory_order_acquire)) {
+            link_t* link = self.deque.pop();
+            if (link == nullptr) {
+                link = take_inbox(self);
+            }
+            for (unsigned i = 1; link == nullptr && i < count; ++i) {
+                victim = (victim + 1) % count;
+                if (victim != self.index) {
+                    link = workers[victim].deque.steal();
+                }
+            }
+
+            if (link != nullptr) {
+                misses = 0;
+                if (!drop_cancelled(*link)) {
+                    step(self, *link);
+                }
+                continue;
+            }
+
+            // nothing anywhere: spin a little, then sleep until someone enqueues
+            if (++misses < 64) {
+                (std::this_thread::yield)();     // parenthesized: yield() is a macro
+                continue;
+            }
+            const std::uint32_t seen = epoch.load(std::memory_order_acquire);
+            sleeping.fetch_add(1, std::memory_order_seq_cst);
+            if (!inbox_pending() && !stopping.load(std::memory_order_acquire)) {
+                epoch.wait(seen, std::memory_order_acquire);
+            }
+            sleeping.fetch_sub(1, std::memory_order_relaxed);
+            misses = 0;
+        }
+        current = nullptr;
+    }
+
+    void step(Worker& self, link_t& link) noexcept {
+        PromiseCore<Policy>::from_link(link).run(link.handle);
+
+        if (link.handle.done()) {
+            untrack(link);
+            link.sink = nullptr;
+            link.release_schedule();
+            if (attached.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                attached.notify_all();
+            }
+            return;
+        }
+
+        link.release_schedule();
+        if (!static_cast<BlockingMixin<Policy>&>(link).is_blocked() && link.try_schedule()) {
+            if (!self.deque.push(link)) {
+                enqueue(link);
+            }
+        }
+    }
+
+    // pull a batch from the shared inbox into our deque, return one link to run
+    link_t* take_inbox(Worker& self) noexcept {
+        if (inbox_lock.test_and_set(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        link_t* first = inbox.pop();
+        if (first != nullptr) {
+            for (std::size_t i = 0; i < DequeCapacity / 2; ++i) {
+                link_t* link = inbox.pop();
+                if (link == nullptr) {
+                    break;
+                }
+                if (!self.deque.push(*link)) {
+                    inbox.push(*link);
+                    break;
+                }
+            }
+        }
+        inbox_lock.clear(std::memory_order_release);
+        return first;
+    }
+
+    bool inbox_pending() noexcept {
+        if (inbox_lock.test_and_set(std::memory_order_acquire)) {
+            return true;
+        }
+        const bool pending = !inbox.empty();
+        inbox_lock.clear(std::memory_order_release);
+        return pending;
+    }
+
+    // the link being destroyed by on_cancel() was taken from a queue: hand it back, do not run it
+    bool drop_cancelled(link_t& link) noexcept {
+        if (cancelling.load(std::memory_order_acquire) != &link) {
+            return false;
+        }
+        cancelling.store(nullptr, std::memory_order_release);
+        return true;
+    }
+
+    void track(link_t& link) noexcept {
+        lock(tracked_lock);
+        tracked.push(link);
+        tracked_lock.clear(std::memory_order_release);
+    }
+
+    void untrack(link_t& link) noexcept {
+        lock(tracked_lock);
+        tracked.remove(link);
+        tracked_lock.clear(std::memory_order_release);
+    }
+
+    static void lock(std::atomic_flag& flag) noexcept {
+        while (flag.test_and_set(std::memory_order_acquire)) {
+            (std::this_thread::yield)();
+        }
+    }
+
+    void enqueue(link_t& link) noexcept {
+        Worker* self = current;
+        // our own worker: its deque; any other thread (or a worker of another executor): the inbox
+        if (self == nullptr || self->owner != this || !self->deque.push(link)) {
+            inbox.push(link);
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_seq_cst) != 0) {
+            wake_all();
+        }
+    }
+
+    void wake_all() noexcept {
+        epoch.fetch_add(1, std::memory_order_release);
+        epoch.notify_all();
+    }
+
+    // any thread
+    static void on_notify(ReadySink<Policy>& sink, link_t& link) noexcept {
+        static_cast<WorkStealingExecutor&>(sink).enqueue(link);
+    }
+
+    // any thread (spawn(), or a running task handing over a child)
+    static void on_attach(ReadySink<Policy>& sink, link_t& link) noexcept {
+        auto& self = static_cast<WorkStealingExecutor&>(sink);
+        link.sink = &self;
+        self.attached.fetch_add(1, std::memory_order_relaxed);
+        self.track(link);
+
+        if (!static_cast<BlockingMixin<Policy>&>(link).is_blocked() && link.try_schedule()) {
+            self.enqueue(link);
+        }
+    }
+
+    // Task destroyed before it finished (owner thread, not while it runs)
+    static void on_cancel(ReadySink<Policy>& sink, link_t& link) noexcept {
+        auto& self = static_cast<WorkStealingExecutor&>(sink);
+        self.untrack(link);
+
+        // not queued: keeping it scheduled stops any late unblock() from queueing it.
+        // Queued (or being queued): a Chase-Lev deque cannot remove from the middle, so the
+        // worker that takes it drops it — wait for that before the frame goes away
+        if (!link.try_schedule()) {
+            lock(self.cancel_lock);
+            self.cancelling.store(&link, std::memory_order_release);
+            self.wake_all();
+            while (self.cancelling.load(std::memory_order_acquire) == &link) {
+                (std::this_thread::yield)();
+            }
+            self.cancel_lock.clear(std::memory_order_release);
+        }
+
+        if (self.attached.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            self.attached.notify_all();
+        }
+    }
+
+    const unsigned count;
+    std::unique_ptr<Worker[]> workers;
+    MpscReadyQueue<Policy> inbox{};
+    std::atomic_flag inbox_lock = ATOMIC_FLAG_INIT;
+    ReadyQueue<Policy> tracked{};               // every attached task, for the destructor
+    std::atomic_flag tracked_lock = ATOMIC_FLAG_INIT;
+    std::atomic<link_t*> cancelling{nullptr};
+    std::atomic_flag cancel_lock = ATOMIC_FLAG_INIT;
+    std::atomic<std::size_t> attached{0};
+    std::atomic<std::uint32_t> epoch{0};
+    std::atomic<unsigned> sleeping{0};
+    std::atomic<bool> stopping{false};
+};
+
+} /* namespace ucoro */
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_EXECUTOR_H
@@ -0,0 +1,161 @@
+#ifndef CORO_GENERATOR_H
+#define CORO_GENERATOR_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+#include "coro_promise.h"
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <utility>
+
+namespace ucoro {
+
+/*
+ * *******************************************************************
+ *  Generator<T, Policy>:
+ *  lazy sequence, `co_yield x` stores only the address of x (a local
+ *  in the frame, or the temporary that lives until the coroutine is
+ *  resumed again) — no copy, any T, including non-copyable ones.
+ *  Policy is used only for frame allocation (see coro_pool.h) and
+ *  error storage (see CompactPolicy).
+ *  Use Generator<const T> to yield const lvalues.
+ *
+ *  ucoro::Generator<Record> records() {
+ *      Record r{};
+ *      while (read(r)) {
+ *          co_yield r;
+ *      }
+ *  }
+ *  for (Record& r : records()) { ... }
+ * *******************************************************************
+*/
+template<class T, class Policy = default_policy>
+class Generator : public std::ranges::view_base {
+public:
+    using value_type = std::remove_cvref_t<T>;
+    using reference  = std::remove_reference_t<T>&;
+    using pointer    = std::remove_reference_t<T>*;
+
+    struct promise_type : PromiseAllocator<Policy>, PromiseError<Policy> {
+        pointer current = nullptr;
+
+        Generator get_return_object() noexcept {
+            return Generator{handle_t::from_promise(*this)};
+        }
+
+        // frame allocation failed — empty sequence, never throw
+        static Generator get_return_object_on_allocation_failure() noexcept {
+            return Generator{};
+        }
+
+        constexpr std::suspend_always initial_suspend() noexcept { return {}; }
+        constexpr std::suspend_always final_suspend()   noexcept { return {}; }
+
+        std::suspend_always yield_value(reference v) noexcept {
+            current = std::addressof(v);
+            return {};
+        }
+
+        // temporary stays alive until the generator is resumed
+        std::suspend_always yield_value(std::remove_reference_t<T>&& v) noexcept requires (!std::is_reference_v<T>) {
+            current = std::addressof(v);
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        // generators produce values, they do not wait for anything
+        template<class U>
+        std::suspend_never await_transform(U&&) = delete;
+    };
+
+    using handle_t = std::coroutine_handle<promise_type>;
+
+    class iterator {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type       = Generator::value_type;
+        using difference_type  = std::ptrdiff_t;
+        using reference        = Generator::reference;
+
+        iterator() noexcept = default;
+        explicit iterator(handle_t h) noexcept : coro(h) {}
+
+        reference operator*() const noexcept { return *coro.promise().current; }
+        pointer operator->() const noexcept { return coro.promise().current; }
+
+        iterator& operator++() {
+            coro.resume();
+            rethrow_if_error(coro);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept {
+            return !it.coro || it.coro.done();
+        }
+
+    private:
+        handle_t coro = nullptr;
+    };
+
+    Generator() noexcept = default;
+    explicit Generator(handle_t h) noexcept : coro(h) {}
+    Generator(const Generator&) = delete;
+    Generator(Generator&& o) noexcept : coro(std::exchange(o.coro, nullptr)) {}
+    Generator& operator=(const Generator&) = delete;
+    Generator& operator=(Generator&& o) noexcept {
+        if (this != &o) {
+            if (coro) {
+                coro.destroy();
+            }
+            coro = std::exchange(o.coro, nullptr);
+        }
+        return *this;
+    }
+
+    ~Generator() {
+        if (coro) {
+            coro.destroy();
+        }
+    }
+
+    bool is_valid() const noexcept { return coro != nullptr; }
+    bool done() const noexcept { return is_valid() ? coro.done() : true; }
+    bool has_error() const noexcept { return is_valid() && coro.promise().has_error(); }
+
+    // starts (or continues) the generator — single pass, like any input range
+    iterator begin() {
+        if (coro && !coro.done()) {
+            coro.resume();
+            rethrow_if_error(coro);
+        }
+        return iterator{coro};
+    }
+
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    static void rethrow_if_error(handle_t h) {
+#if defined(__cpp_exceptions)
+        if constexpr (std::is_same_v<typename promise_type::error_t, std::exception_ptr>) {
+            if (h.promise().error) {
+                std::rethrow_exception(h.promise().error);
+            }
+        }
+#else
+        (void)h;
+#endif
+    }
+
+    handle_t coro = nullptr;
+};
+
+} /* namespace ucoro */
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_GENERATOR_H
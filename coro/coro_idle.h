@@ -0,0 +1,262 @@
+#ifndef CORO_IDLE_H
+#define CORO_IDLE_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+#include "coro_event.h"
+#include "coro_timer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__linux__)
+#   include <linux/futex.h>
+#   include <sys/syscall.h>
+#   include <ctime>
+#   include <unistd.h>
+#else
+#   include <condition_variable>
+#   include <mutex>
+#endif
+
+namespace ucoro {
+
+/*
+ * *******************************************************************
+ *  IdleSignal:
+ *  lets the host thread sleep until another context has something
+ *  for it. notify() bumps a wake counter and, only if somebody is
+ *  asleep, wakes it: one futex syscall on Linux (async-signal-safe),
+ *  a mutex + condition variable elsewhere (not signal-safe there).
+ *  Sleeper protocol (no lost wakeups):
+ *      seen = prepare();  re-check for work;  wait(seen, timeout);  finish();
+ *  This is the idle source interface of TicklessLoop; poll() collects
+ *  work without sleeping (none here, see EpollReactor).
+ * *******************************************************************
+*/
+class IdleSignal {
+public:
+    IdleSignal() noexcept = default;
+    IdleSignal(const IdleSignal&) = delete;
+    IdleSignal& operator=(const IdleSignal&) = delete;
+
+    // any context
+    void notify() noexcept {
+        word.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) == 0) {
+            return;
+        }
+#if defined(__linux__)
+        syscall(SYS_futex, futex_word(), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+        std::lock_guard<std::mutex> lock(mutex);
+        cv.notify_one();
+#endif
+    }
+
+    // hook for Scheduler::set_wake_hook() / BasicEventController::set_post_hook()
+    Waker waker() noexcept { return Waker{&IdleSignal::on_wake, this}; }
+
+    // announce the sleeper, then re-check for work before wait()
+    std::uint32_t prepare() noexcept {
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        return word.load(std::memory_order_seq_cst);
+    }
+
+    // sleep while nothing was notified since prepare(), at most timeout_ns (< 0 — no limit)
+    void wait(std::uint32_t seen, std::int64_t timeout_ns) noexcept {
+#if defined(__linux__)
+        timespec ts{};
+        timespec* limit = nullptr;
+        if (timeout_ns >= 0) {
+            ts.tv_sec = static_cast<std::time_t>(timeout_ns / 1000000000);
+            ts.tv_nsec = static_cast<long>(timeout_ns % 1000000000);
+            limit = &ts;
+        }
+        // EAGAIN (already notified), EINTR and ETIMEDOUT all just return
+        syscall(SYS_futex, futex_word(), FUTEX_WAIT_PRIVATE, seen, limit, nullptr, 0);
+#else
+        std::unique_lock<std::mutex> lock(mutex);
+        auto notified = [&] { return word.load(std::memory_order_seq_cst) != seen; };
+        if (timeout_ns < 0) {
+            cv.wait(lock, notified);
+        } else {
+            cv.wait_for(lock, std::chrono::nanoseconds(timeout_ns), notified);
+        }
+#endif
+    }
+
+    void finish() noexcept { sleepers.fetch_sub(1, std::memory_order_relaxed); }
+
+    std::size_t poll() noexcept { return 0; }
+
+private:
+    static void on_wake(void* self) noexcept { static_cast<IdleSignal*>(self)->notify(); }
+
+#if defined(__linux__)
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t) &&
+                  std::atomic<std::uint32_t>::is_always_lock_free,
+                  "[UCORO]: futex needs a plain 32-bit atomic word");
+
+    std::uint32_t* futex_word() noexcept { return reinterpret_cast<std::uint32_t*>(&word); }
+#else
+    std::mutex mutex;
+    std::condition_variable cv;
+#endif
+
+    std::atomic<std::uint32_t> word{0};
+    std::atomic<std::uint32_t> sleepers{0};
+};
+
+// where a TicklessLoop spent its idle time
+struct IdleStats {
+    std::size_t sleeps = 0;             // times the thread went to sleep
+    std::size_t timer_wakes = 0;        // ... and was woken by the next timer deadline
+    std::uint64_t slept_ns = 0;         // total time asleep
+};
+
+/*
+ * *******************************************************************
+ *  TicklessLoop:
+ *  host run loop for a Scheduler / PriorityScheduler / EdfScheduler.
+ *  Feeds the timer wheel from Clock (one wheel tick = `tick`), hands
+ *  posted events to the controller and runs ready tasks. When nothing
+ *  is runnable it sleeps until the next timer deadline or until
+ *  the controller's post() / unblock() from another thread (atomic
+ *  policies) wakes it — no busy spinning, no fixed delay.
+ *  Owns the wheel's advance() and the hooks of the scheduler / event
+ *  controller (any BasicEventController, or none) while it exists.
+ *  The thread sleeps in an own IdleSignal, or in the given idle
+ *  source (e.g. EpollReactor: sleeps in epoll_wait(), polled once
+ *  per pass).
+ *
+ *  ucoro::Scheduler<ucoro::PlainPolicy> sched;
+ *  sched.spawn(blink);
+ *  ucoro::TicklessLoop loop(sched, std::chrono::milliseconds(1));
+ *  loop.run();                         // until every task finished
+ * *******************************************************************
+*/
+template<class Sched, class Idle = IdleSignal, class Wheel = default_timer_wheel, class Clock = std::chrono::steady_clock,
+         class Events = EventController>
+class TicklessLoop {
+public:
+    using duration = typename Clock::duration;
+
+    explicit TicklessLoop(Sched& scheduler, duration tick_length = std::chrono::milliseconds(1),
+                          Wheel& clock_wheel = timer_wheel, Events* controller = &event_controller) noexcept
+        requires std::is_same_v<Idle, IdleSignal>
+        : TicklessLoop(scheduler, own, tick_length, clock_wheel, controller) {}
+
+    TicklessLoop(Sched& scheduler, Idle& source, duration tick_length = std::chrono::milliseconds(1),
+                 Wheel& clock_wheel = timer_wheel, Events* controller = &event_controller) noexcept
+        : sched(scheduler), wheel(clock_wheel), events(controller), tick(tick_length)
+        , base_tick(clock_wheel.now()), base_time(Clock::now()), signal(source)
+    {
+        sched.set_wake_hook(signal.waker());
+        if (events != nullptr) {
+            events->set_post_hook(signal.waker());
+        }
+    }
+
+    TicklessLoop(const TicklessLoop&) = delete;
+    TicklessLoop& operator=(const TicklessLoop&) = delete;
+
+    ~TicklessLoop() {
+        sched.set_wake_hook(Waker{});
+        if (events != nullptr) {
+            events->set_post_hook(Waker{});
+        }
+    }
+
+    // one pass: posted events, idle source (I/O), expired timers, then the ready tasks; returns how many ran
+    std::size_t poll() noexcept {
+        if (events != nullptr) {
+            events->dispatch_posted();
+        }
+        if (!slept) {
+            signal.poll();      // right after sleep() the source is already polled
+        }
+        slept = false;
+        advance_wheel();
+        return sched.run_once();
+    }
+
+    // until no task is attached
+    void run() noexcept {
+        while (sched.active() != 0) {
+            if (poll() == 0) {
+                sleep();
+            }
+        }
+    }
+
+    // sleep until the next timer deadline or a wake signal; returns at once if there is work
+    void sleep() noexcept {
+        const std::uint32_t seen = signal.prepare();
+        if (!sched.idle() || (events != nullptr && events->has_posted())) {
+            signal.finish();
+            return;
+        }
+
+        std::int64_t timeout = -1;
+        tick_t next = 0;
+        if (wheel.next_expiry(next)) {
+            const auto due = base_time + tick * static_cast<std::int32_t>(next - base_tick);
+            const auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(due - Clock::now()).count();
+            if (left <= 0) {
+                signal.finish();
+                return;
+            }
+            timeout = static_cast<std::int64_t>(left);
+        }
+
+        const auto start = Clock::now();
+        signal.wait(seen, timeout);
+        const auto stop = Clock::now();
+        signal.finish();
+        slept = true;
+
+        ++idle.sleeps;
+        idle.slept_ns += static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+        if (timeout >= 0 && std::chrono::nanoseconds(timeout) <= stop - start) {
+            ++idle.timer_wakes;
+        }
+    }
+
+    const IdleStats& stats() const noexcept { return idle; }
+    void reset_stats() noexcept { idle = IdleStats{}; }
+
+    // wakes the loop from any context (e.g. after feeding an external queue)
+    void wake() noexcept { signal.notify(); }
+
+private:
+    // whole ticks since the last advance; the remainder carries over
+    void advance_wheel() noexcept {
+        const auto elapsed = (Clock::now() - base_time) / tick;
+        if (elapsed > 0) {
+            base_time += tick * elapsed;
+            base_tick += static_cast<tick_t>(elapsed);
+            wheel.advance(base_tick);
+        }
+    }
+
+    Sched& sched;
+    Wheel& wheel;
+    Events* events;
+    duration tick;
+    tick_t base_tick;
+    typename Clock::time_point base_time;
+    [[no_unique_address]] std::conditional_t<std::is_same_v<Idle, IdleSignal>, IdleSignal, NoHook> own{};
+    Idle& signal;
+    IdleStats idle{};
+    bool slept = false;
+};
+
+} /* namespace ucoro */
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_IDLE_H
@@ -0,0 +1,319 @@
+#ifndef CORO_MIXED_H
+#define CORO_MIXED_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+#include "coro_scheduler.h"
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ucoro {
+
+/*
+ * *******************************************************************
+ *  MixedScheduler units:
+ *  every kind of work is wrapped into a unit with the same shape —
+ *  active() (not finished), ready() (has something to run now) and
+ *  run() (one pass, returns how much ran). The unit type is picked at
+ *  compile time from the object type, so a pass makes direct calls.
+ * *******************************************************************
+*/
+
+// Task of a blocking policy, moved in: its own intrusive Scheduler, so block()/unblock(),
+// timers, events and when_all / when_any children work as usual. The task is declared after
+// the scheduler, so it (with its children) detaches while the scheduler still exists
+template<class T, class Policy>
+class MixedTaskUnit {
+public:
+    explicit MixedTaskUnit(Task<T, Policy>&& t) noexcept : task(std::move(t)) { sched.spawn(task); }
+    MixedTaskUnit(const MixedTaskUnit&) = delete;
+    MixedTaskUnit& operator=(const MixedTaskUnit&) = delete;
+
+    bool active() const noexcept { return sched.active() != 0; }
+    bool ready() const noexcept { return !sched.idle(); }
+    std::size_t run() noexcept { return sched.run_once(); }
+    void set_wake_hook(Waker hook) noexcept { sched.set_wake_hook(hook); }
+    Task<T, Policy>& object() noexcept { return task; }
+
+private:
+    Scheduler<Policy> sched;
+    Task<T, Policy> task;
+};
+
+// Task of a non-blocking policy, moved in: resumed every pass (it polls its conditions itself)
+template<class T, class Policy>
+class MixedPolledTaskUnit {
+public:
+    explicit MixedPolledTaskUnit(Task<T, Policy>&& t) noexcept : task(std::move(t)) {}
+
+    bool active() const noexcept { return !task.done(); }
+    constexpr bool ready() const noexcept { return true; }
+    std::size_t run() noexcept {
+        task.resume();
+        return 1;
+    }
+    void set_wake_hook(Waker) noexcept {}
+    Task<T, Policy>& object() noexcept { return task; }
+
+private:
+    Task<T, Policy> task;
+};
+
+// an existing Scheduler / PriorityScheduler / EdfScheduler with its tasks
+template<class Sched>
+class MixedSchedulerUnit {
+public:
+    explicit MixedSchedulerUnit(Sched& s) noexcept : sched(s) {}
+
+    bool active() const noexcept { return sched.active() != 0; }
+    bool ready() const noexcept { return !sched.idle(); }
+    std::size_t run() noexcept { return sched.run_once(); }
+    void set_wake_hook(Waker hook) noexcept { sched.set_wake_hook(hook); }
+    Sched& object() noexcept { return sched; }
+
+private:
+    Sched& sched;
+};
+
+// Protothread / StaticProtothread: Run() every pass while it is running. The call is qualified
+// with the object's own type, so an override of the virtual Protothread::Run() is called directly
+template<class Thread>
+class MixedProtothreadUnit {
+    static_assert(!std::is_abstract_v<Thread>,
+                  "[UCORO]: MixedScheduler needs the protothread by its own type, not by an abstract base");
+
+public:
+    explicit MixedProtothreadUnit(Thread& t) noexcept : thread(t) {}
+
+    bool active() const noexcept { return thread.IsRunning(); }
+    constexpr bool ready() const noexcept { return true; }
+    std::size_t run() noexcept {
+        thread.Thread::Run();
+        return 1;
+    }
+    void set_wake_hook(Waker) noexcept {}
+    Thread& object() noexcept { return thread; }
+
+private:
+    Thread& thread;
+};
+
+// InstantCoroutine (CoroutineDefine without resume parameters): called every pass until finished
+template<class Coroutine>
+class MixedCoroutineUnit {
+public:
+    explicit MixedCoroutineUnit(Coroutine& c) noexcept : coroutine(c) {}
+
+    bool active() const noexcept { return !coroutine.Finished(); }
+    constexpr bool ready() const noexcept { return true; }
+    std::size_t run() noexcept {
+        coroutine();
+        return 1;
+    }
+    void set_wake_hook(Waker) noexcept {}
+    Coroutine& object() noexcept { return coroutine; }
+
+private:
+    Coroutine& coroutine;
+};
+
+template<class X>
+concept mixed_scheduler = requires(X& x, const X& cx, Waker w) {
+    { x.run_once() } -> std::convertible_to<std::size_t>;
+    { cx.idle() } -> std::convertible_to<bool>;
+    { cx.active() } -> std::convertible_to<std::size_t>;
+    x.set_wake_hook(w);
+};
+
+template<class X>
+concept mixed_protothread = requires(X& x, const X& cx) {
+    { x.Run() } -> std::convertible_to<bool>;
+    { cx.IsRunning() } -> std::convertible_to<bool>;
+};
+
+template<class X>
+concept mixed_coroutine = requires(X& x, const X& cx) {
+    { cx.Finished() } -> std::convertible_to<bool>;
+    x();
+};
+
+template<class X>
+struct mixed_unit {
+    static_assert(sizeof(X) == 0, "[UCORO]: MixedScheduler takes Tasks, schedulers, protothreads and InstantCoroutines");
+};
+
+template<class T, class Policy>
+struct mixed_unit<Task<T, Policy>> {
+    using type = std::conditional_t<use_scheduler_v<Policy>, MixedTaskUnit<T, Policy>, MixedPolledTaskUnit<T, Policy>>;
+};
+
+template<mixed_scheduler X>
+struct mixed_unit<X> {
+    using type = MixedSchedulerUnit<X>;
+};
+
+template<mixed_protothread X>
+struct mixed_unit<X> {
+    using type = MixedProtothreadUnit<X>;
+};
+
+template<mixed_coroutine X>
+struct mixed_unit<X> {
+    using type = MixedCoroutineUnit<X>;
+};
+
+template<class X>
+using mixed_unit_t = typename mixed_unit<X>::type;
+
+// Tasks are moved into their unit; every other unit keeps a reference to the caller's object
+template<class X>
+inline constexpr bool mixed_owned_v = false;
+
+template<class T, class Policy>
+inline constexpr bool mixed_owned_v<Task<T, Policy>> = true;
+
+// hands an object to its unit (decltype(auto): checked before the unit is picked)
+template<class Arg>
+constexpr decltype(auto) mixed_take(Arg&& obj) noexcept {
+    static_assert(mixed_owned_v<std::remove_cvref_t<Arg>> != std::is_lvalue_reference_v<Arg>,
+                  "[UCORO]: MixedScheduler takes Tasks by value (std::move) and other objects by reference");
+    return std::forward<Arg>(obj);
+}
+
+/*
+ * *******************************************************************
+ *  MixedScheduler:
+ *  one run loop for ucoro::Task, Protothread / StaticProtothread and
+ *  CoroutineDefine functors (and whole schedulers). Tasks are moved
+ *  in and owned by the scheduler (get<I>() reaches them); the other
+ *  objects stay owned by the caller. The scheduler keeps a std::tuple
+ *  of units, no allocation, no virtual dispatch (a Protothread's Run()
+ *  is called by its own type) — swapping a protothread for a Task
+ *  changes only the declaration, not the loop.
+ *  Ready / blocked model, the same for every unit:
+ *   - a unit runs in a pass if it is active (not finished), not
+ *     blocked, and ready: a Task when its scheduler has a ready task
+ *     (block()/unblock() of the promise), a polled unit (protothread,
+ *     InstantCoroutine, non-blocking Task) always;
+ *   - block(i) / unblock(i) / waker<I>() park and wake unit i from
+ *     outside — e.g. a protothread that has nothing to do until an
+ *     interrupt; unblock() may run in any context.
+ *  Same interface as Scheduler (run_once / active / idle /
+ *  set_wake_hook), so TicklessLoop can drive it.
+ *  NOTE: at most 64 units; do not run the objects elsewhere meanwhile.
+ *
+ *  Blink blink;                                // StaticProtothread
+ *  Parser parser;                              // CoroutineDefine
+ *  ucoro::MixedScheduler sched(read_sensor(), blink, parser);
+ *  while (sched.active()) { sched.run_once(); }
+ * *******************************************************************
+*/
+template<class... Objs>
+class MixedScheduler {
+    static_assert(sizeof...(Objs) > 0 && sizeof...(Objs) <= 64, "[UCORO]: MixedScheduler holds 1..64 units");
+
+public:
+    static constexpr std::size_t size = sizeof...(Objs);
+
+    template<class... Args>
+    explicit MixedScheduler(Args&&... objs) noexcept : units(mixed_take(std::forward<Args>(objs))...) {}
+    MixedScheduler(const MixedScheduler&) = delete;
+    MixedScheduler& operator=(const MixedScheduler&) = delete;
+
+    // one pass over the units in declaration order, returns how many tasks / polled units ran
+    std::size_t run_once() noexcept {
+        const std::uint64_t skip = parked.load(std::memory_order_acquire);
+        return run_units(skip, std::index_sequence_for<Objs...>{});
+    }
+
+    // units that did not finish
+    std::size_t active() const noexcept {
+        return count_units([](const auto& unit) { return unit.active(); }, std::index_sequence_for<Objs...>{});
+    }
+
+    // nothing to run now (a running polled unit that is not blocked is never idle)
+    bool idle() const noexcept {
+        const std::uint64_t skip = parked.load(std::memory_order_acquire);
+        return runnable_units(skip, std::index_sequence_for<Objs...>{}) == 0;
+    }
+
+    // park unit i until unblock(i)
+    void block(std::size_t i) noexcept { parked.fetch_or(bit(i), std::memory_order_acq_rel); }
+
+    // any context
+    void unblock(std::size_t i) noexcept {
+        if ((parked.fetch_and(~bit(i), std::memory_order_acq_rel) & bit(i)) != 0 && wake_hook) {
+            wake_hook();
+        }
+    }
+
+    bool is_blocked(std::size_t i) const noexcept { return (parked.load(std::memory_order_acquire) & bit(i)) != 0; }
+
+    // object of unit I: the Task it owns, or the caller's object
+    template<std::size_t I>
+    auto& get() noexcept { return std::get<I>(units).object(); }
+
+    // unblock(I) as a Waker (event post hook, timer, IdleSignal-style callbacks)
+    template<std::size_t I>
+    Waker waker() noexcept {
+        static_assert(I < size, "[UCORO]: MixedScheduler unit index out of range");
+        return Waker{&MixedScheduler::on_wake<I>, this};
+    }
+
+    // called after unblock() and after a Task unit was woken from another context; set it before running
+    void set_wake_hook(Waker hook) noexcept {
+        wake_hook = hook;
+        std::apply([hook](auto&... unit) { (unit.set_wake_hook(hook), ...); }, units);
+    }
+
+private:
+    static constexpr std::uint64_t bit(std::size_t i) noexcept { return std::uint64_t{1} << i; }
+
+    template<std::size_t I>
+    static void on_wake(void* self) noexcept { static_cast<MixedScheduler*>(self)->unblock(I); }
+
+    template<std::size_t I>
+    std::size_t run_unit(std::uint64_t skip) noexcept {
+        auto& unit = std::get<I>(units);
+        if ((skip & bit(I)) != 0 || !unit.active() || !unit.ready()) {
+            return 0;
+        }
+        return unit.run();
+    }
+
+    template<std::size_t... I>
+    std::size_t run_units(std::uint64_t skip, std::index_sequence<I...>) noexcept {
+        std::size_t ran = 0;
+        ((ran += run_unit<I>(skip)), ...);
+        return ran;
+    }
+
+    template<std::size_t... I>
+    std::size_t runnable_units(std::uint64_t skip, std::index_sequence<I...>) const noexcept {
+        return (std::size_t{0} + ... +
+                std::size_t((skip & bit(I)) == 0 && std::get<I>(units).active() && std::get<I>(units).ready()));
+    }
+
+    template<class F, std::size_t... I>
+    std::size_t count_units(F f, std::index_sequence<I...>) const noexcept {
+        return (std::size_t{0} + ... + std::size_t(f(std::get<I>(units))));
+    }
+
+    std::tuple<mixed_unit_t<Objs>...> units;
+    std::atomic<std::uint64_t> parked{0};
+    Waker wake_hook{};
+};
+
+template<class... Args>
+MixedScheduler(Args&&...) -> MixedScheduler<std::remove_cvref_t<Args>...>;
+
+} /* namespace ucoro */
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_MIXED_H
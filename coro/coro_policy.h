@@ -10,6 +10,10 @@
 #   define UCORO_ENABLED 1
 #   include <atomic>
 #   include <coroutine>
+#   include <cstddef>
+#   include <exception>
+#   include <new>
+#   include <type_traits>
 #else
 #   define UCORO_ENABLED 0
 #endif
@@ -53,6 +57,150 @@ struct NoBlockPolicy {
 };
 
 using default_policy = NoBlockPolicy;
+
+/*
+ * *******************************************************************
+ *  Frame allocation:
+ *  a policy may declare `using frame_allocator = X;` where X provides
+ *  static allocate(size)/deallocate(ptr, size), both noexcept.
+ *  allocate() returns nullptr on failure — the task is then invalid.
+ * *******************************************************************
+*/
+struct HeapFrameAllocator {
+    static void* allocate(std::size_t size) noexcept {
+        return ::operator new(size, std::nothrow);
+    }
+
+    static void deallocate(void* ptr, std::size_t size) noexcept {
+        ::operator delete(ptr, size);
+    }
+};
+
+template<class Policy, class = void>
+struct policy_frame_allocator {
+    using type = HeapFrameAllocator;
+};
+
+template<class Policy>
+struct policy_frame_allocator<Policy, std::void_t<typename Policy::frame_allocator>> {
+    using type = typename Policy::frame_allocator;
+};
+
+template<class Policy>
+using frame_allocator_t = typename policy_frame_allocator<Policy>::type;
+
+// any policy + custom frame allocator (e.g. FramePool from coro_pool.h)
+template<class Allocator, class Base = default_policy>
+struct PooledPolicy : Base {
+    using frame_allocator = Allocator;
+};
+
+/*
+ * *******************************************************************
+ *  Instrumentation:
+ *  a policy may declare `using stats_clock = C;` where C provides
+ *  static now() noexcept returning unsigned ticks. Every task then
+ *  keeps TaskStats (coro_stats.h); other policies pay nothing.
+ * *******************************************************************
+*/
+template<class Policy, class = void>
+struct policy_stats_clock {
+    using type = void;
+};
+
+template<class Policy>
+struct policy_stats_clock<Policy, std::void_t<typename Policy::stats_clock>> {
+    using type = typename Policy::stats_clock;
+};
+
+template<class Policy>
+inline constexpr bool use_stats_v = !std::is_void_v<typename policy_stats_clock<Policy>::type>;
+
+// any policy + per-task statistics (e.g. SteadyStatsClock from coro_stats.h)
+template<class Clock, class Base = default_policy>
+struct InstrumentedPolicy : Base {
+    using stats_clock = Clock;
+};
+
+/*
+ * *******************************************************************
+ *  Error storage:
+ *  a policy may declare `using error_type = E;` to replace the
+ *  std::exception_ptr every promise carries by default:
+ *  - NoError          : nothing stored, an escaping exception terminates
+ *  - integral / enum  : error code, E{} means "no error"; an escaping
+ *                       exception stores static_cast<E>(-1), so an
+ *                       enum needs a fixed underlying type (enum class,
+ *                       or `enum E : int`) to hold it
+ *  Neither touches the exception runtime (fine for -fno-exceptions).
+ * *******************************************************************
+*/
+struct NoError {
+    constexpr bool operator==(const NoError&) const noexcept = default;
+};
+
+template<class Policy, class = void>
+struct policy_error {
+    using type = std::exception_ptr;
+};
+
+template<class Policy>
+struct policy_error<Policy, std::void_t<typename Policy::error_type>> {
+    using type = typename Policy::error_type;
+};
+
+template<class Policy>
+using error_t = typename policy_error<Policy>::type;
+
+// E{underlying} compiles only for an enum with a fixed underlying type
+template<class E>
+inline constexpr bool error_code_v = std::is_integral_v<E> || requires { E{std::underlying_type_t<E>{}}; };
+
+// any policy + compact error storage (NoError or an error code type)
+template<class Error = NoError, class Base = default_policy>
+struct CompactPolicy : Base {
+    static_assert(std::is_same_v<Error, NoError> || error_code_v<Error>,
+                  "[UCORO]: CompactPolicy error must be NoError, an integral or an enum type with a fixed underlying type");
+    using error_type = Error;
+};
+
+/*
+ * *******************************************************************
+ *  Promise footprint:
+ *  every promise carries what Task needs beyond resume(), unless the
+ *  policy turns it off (`static constexpr bool X = false;`):
+ *  - use_await     : await chain (root, innermost frame, parent,
+ *                    on_finish) — `co_await task`, when_all/when_any
+ *  - use_scheduler : ready link (blocking policies only) — Scheduler,
+ *                    PriorityScheduler, EdfScheduler, executor
+ *  Without both a blocking frame is as small as before either existed.
+ * *******************************************************************
+*/
+template<class Policy, class = void>
+struct policy_await : std::true_type { };
+
+template<class Policy>
+struct policy_await<Policy, std::void_t<decltype(Policy::use_await)>> : std::bool_constant<Policy::use_await> { };
+
+template<class Policy>
+inline constexpr bool use_await_v = policy_await<Policy>::value;
+
+template<class Policy, class = void>
+struct policy_scheduler : std::bool_constant<Policy::use_blocking> { };
+
+template<class Policy>
+struct policy_scheduler<Policy, std::void_t<decltype(Policy::use_scheduler)>>
+    : std::bool_constant<Policy::use_blocking && Policy::use_scheduler> { };
+
+template<class Policy>
+inline constexpr bool use_scheduler_v = policy_scheduler<Policy>::value;
+
+// any policy without await chain and ready link: driven by Task::resume() only
+template<class Base = default_policy>
+struct LeanPolicy : Base {
+    static constexpr bool use_await     = false;
+    static constexpr bool use_scheduler = false;
+};
 }
 
 #endif /* **********************UCORO_ENABLED*************************** */
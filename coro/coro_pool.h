@@ -0,0 +1,171 @@
+#ifndef CORO_POOL_H
+#define CORO_POOL_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+
+namespace ucoro {
+
+/*
+ * *******************************************************************
+ *  SizeClass: BlockCount blocks of (at least) BlockSize bytes
+ * *******************************************************************
+*/
+template<std::size_t BlockSize, std::size_t BlockCount>
+struct SizeClass {
+    static_assert(BlockSize > 0 && BlockCount > 0, "[UCORO]: empty size class");
+
+    static constexpr std::size_t align = alignof(std::max_align_t);
+    static constexpr std::size_t block_size = (BlockSize + align - 1) / align * align;
+    static constexpr std::size_t block_count = BlockCount;
+};
+
+struct FramePoolStats {
+    std::size_t in_use      = 0;   // blocks currently allocated
+    std::size_t high_water  = 0;   // max in_use ever seen
+    std::size_t failures    = 0;   // requests this class could not serve
+    std::size_t capacity    = 0;   // total blocks
+    std::size_t block_size  = 0;   // 0 for the pool-wide summary
+};
+
+/*
+ * *******************************************************************
+ *  FramePool:
+ *  static, compile-time sized storage for coroutine frames.
+ *  Request goes to the smallest class that fits; if that class is
+ *  exhausted it spills into the next larger one. When nothing fits,
+ *  allocate() returns nullptr and the Task is created invalid
+ *  (get_return_object_on_allocation_failure).
+ *  NOTE: not thread/ISR safe, create and destroy tasks from one context.
+ *
+ *  using Pool = ucoro::FramePool<SizeClass<128, 32>, SizeClass<512, 8>>;
+ *  using MyPolicy = ucoro::PooledPolicy<Pool, ucoro::PlainPolicy>;
+ * *******************************************************************
+*/
+template<class... Classes>
+class FramePool {
+    static_assert(sizeof...(Classes) > 0, "[UCORO]: FramePool needs at least one SizeClass");
+
+    static constexpr bool sorted() noexcept {
+        constexpr std::size_t sizes[] = { Classes::block_size... };
+        for (std::size_t i = 1; i < sizeof...(Classes); ++i) {
+            if (sizes[i - 1] >= sizes[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static_assert(sorted(), "[UCORO]: SizeClass list must be strictly ascending by block size");
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    template<class Class>
+    struct Arena {
+        alignas(std::max_align_t) std::uint8_t storage[Class::block_size * Class::block_count];
+        FreeBlock* free_list    = nullptr;  // recycled blocks
+        std::size_t untouched   = 0;        // bump index of never used blocks
+        FramePoolStats stats{0, 0, 0, Class::block_count, Class::block_size};
+
+        void* take() noexcept {
+            void* p = nullptr;
+            if (free_list) {
+                p = free_list;
+                free_list = free_list->next;
+            } else if (untouched < Class::block_count) {
+                p = storage + (untouched++) * Class::block_size;
+            } else {
+                return nullptr;
+            }
+
+            if (++stats.in_use > stats.high_water) {
+                stats.high_water = stats.in_use;
+            }
+            return p;
+        }
+
+        bool owns(const void* p) const noexcept {
+            auto* b = static_cast<const std::uint8_t*>(p);
+            return b >= storage && b < storage + sizeof(storage);
+        }
+
+        void give(void* p) noexcept {
+            auto* block = static_cast<FreeBlock*>(p);
+            block->next = free_list;
+            free_list = block;
+            --stats.in_use;
+        }
+    };
+
+    using arenas_t = std::tuple<Arena<Classes>...>;
+
+    inline static arenas_t arenas{};
+    inline static FramePoolStats summary{0, 0, 0, (Classes::block_count + ...), 0};
+
+public:
+    static constexpr std::size_t class_count = sizeof...(Classes);
+    static constexpr std::size_t max_block_size = std::max({ Classes::block_size... });
+
+    static void* allocate(std::size_t size) noexcept {
+        void* p = nullptr;
+        std::apply([&](auto&... arena) {
+            // first fitting class with a free block wins
+            ((p == nullptr && size <= arena_block_size(arena)
+                ? (p = arena.take(), p == nullptr ? (void)++arena.stats.failures : (void)0)
+                : (void)0), ...);
+        }, arenas);
+
+        if (p == nullptr) {
+            ++summary.failures;
+        } else if (++summary.in_use > summary.high_water) {
+            summary.high_water = summary.in_use;
+        }
+        return p;
+    }
+
+    static void deallocate(void* ptr, std::size_t) noexcept {
+        if (ptr == nullptr) {
+            return;
+        }
+        bool released = false;
+        std::apply([&](auto&... arena) {
+            ((!released && arena.owns(ptr) ? (arena.give(ptr), released = true) : false), ...);
+        }, arenas);
+
+        if (released) {
+            --summary.in_use;
+        }
+    }
+
+    // per class statistics, index follows Classes order
+    static FramePoolStats class_stats(std::size_t index) noexcept {
+        FramePoolStats out{};
+        std::size_t i = 0;
+        std::apply([&](auto&... arena) {
+            ((i++ == index ? (out = arena.stats, true) : false), ...);
+        }, arenas);
+        return out;
+    }
+
+    // pool-wide summary, failures = requests no class could serve
+    static FramePoolStats stats() noexcept {
+        return summary;
+    }
+
+private:
+    template<class Class>
+    static constexpr std::size_t arena_block_size(const Arena<Class>&) noexcept {
+        return Class::block_size;
+    }
+};
+
+} /* namespace ucoro */
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_POOL_H
@@ -0,0 +1,100 @@
+#ifndef CORO_PRIORITY_H
+#define CORO_PRIORITY_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+#include "coro_scheduler.h"
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+namespace ucoro {
+
+/*
+ * *******************************************************************
+ *  PriorityScheduler:
+ *  Scheduler with Levels fixed priorities (Levels-1 — highest). One
+ *  intrusive FIFO per level plus a bitmap of non-empty levels; the
+ *  next task is found with one count-leading-zeros, O(1) whatever the
+ *  number of tasks. A runnable higher-priority task always runs
+ *  first; equal priorities round-robin on yield.
+ *  Same ownership and threading rules as Scheduler.
+ *
+ *  ucoro::PriorityScheduler<ucoro::PlainPolicy, 4> sched;
+ *  sched.spawn(control_loop, 3);
+ *  sched.spawn(housekeeping, 0);
+ *  while (sched.active()) { sched.run_next(); }
+ * *******************************************************************
+*/
+template<class Policy, std::size_t Levels = 8>
+class PriorityScheduler : public BasicScheduler<PriorityScheduler<Policy, Levels>, Policy> {
+    static_assert(Levels >= 1 && Levels <= 64, "[UCORO]: PriorityScheduler supports 1..64 levels");
+
+    using base_t = BasicScheduler<PriorityScheduler<Policy, Levels>, Policy>;
+    friend base_t;
+
+public:
+    using link_t = ReadyLink<Policy>;
+    using mask_t = std::conditional_t<(Levels <= 32), std::uint32_t, std::uint64_t>;
+
+    static constexpr std::size_t levels = Levels;
+
+    PriorityScheduler() noexcept = default;
+
+    // attach task at priority (clamped to Levels-1); false if invalid, finished or attached elsewhere
+    template<class T>
+    bool spawn(Task<T, Policy>& task, std::size_t priority) noexcept {
+        link_t* link = base_t::claim(task);
+        if (link == nullptr) {
+            return false;
+        }
+        link->sched_key = static_cast<std::uint32_t>(priority < Levels ? priority : Levels - 1);
+        this->attach(*link);
+        return true;
+    }
+
+    std::size_t ready_count() const noexcept { return ready_total; }
+
+private:
+    static constexpr mask_t bit(std::uint32_t level) noexcept { return mask_t(1) << level; }
+
+    void push(link_t& link) noexcept {
+        ready[link.sched_key].push(link);
+        ready_mask |= bit(link.sched_key);
+        ++ready_total;
+    }
+
+    link_t* pop_next() noexcept {
+        if (ready_mask == 0) {
+            return nullptr;
+        }
+        const auto level = static_cast<std::uint32_t>(
+            std::numeric_limits<mask_t>::digits - 1 - std::countl_zero(ready_mask));
+        link_t* link = ready[level].pop();
+        if (ready[level].empty()) {
+            ready_mask &= ~bit(level);
+        }
+        --ready_total;
+        return link;
+    }
+
+    // linked() links only: sched_key is the level spawn() clamped (or a child copied from its parent)
+    void remove(link_t& link) noexcept {
+        ready[link.sched_key].remove(link);
+        if (ready[link.sched_key].empty()) {
+            ready_mask &= ~bit(link.sched_key);
+        }
+        --ready_total;
+    }
+
+    ReadyQueue<Policy> ready[Levels];
+    mask_t ready_mask = 0;
+    std::size_t ready_total = 0;
+};
+
+} /* namespace ucoro */
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_PRIORITY_H
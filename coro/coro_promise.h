@@ -5,14 +5,91 @@
 
 #if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
 
+#include "coro_stats.h"
+#include "coro_trace.h"
+#include <cstdint>
 #include <exception>
 
 namespace ucoro {
 
+/*
+ * *******************************************************************
+ *  Ready link:
+ *  intrusive hook stored in every blocking promise, lets a scheduler
+ *  queue the task without any allocation. `sink` is whoever wants to
+ *  hear about unblock(); `scheduled` is true while the task sits in
+ *  the sink queue or is being resumed by it. `sched_key` and
+ *  `sched_flags` belong to the sink (priority level, deadline, ...).
+ *  The byte fields come last: the blocking flag of BlockingMixin
+ *  fits in the tail padding. Absent unless use_scheduler_v<Policy>.
+ * *******************************************************************
+*/
+struct ReadyHook {
+    ReadyHook* next = nullptr;
+    ReadyHook* prev = nullptr;
+
+    bool linked() const noexcept { return next != nullptr; }
+};
+
+template<class Policy>
+struct ReadyLink;
+
+template<class Policy>
+struct ReadySink {
+    void (*notify)(ReadySink&, ReadyLink<Policy>&) noexcept;    // link became runnable
+    void (*cancel)(ReadySink&, ReadyLink<Policy>&) noexcept;    // link is going away
+    void (*attach)(ReadySink&, ReadyLink<Policy>&) noexcept;    // take over a new link (handle set)
+};
+
+struct NoHook { };
+
+template<class Policy>
+struct ReadyLink : ReadyHook {
+    using inbox_hook_t = std::conditional_t<Policy::is_atomic, std::atomic<ReadyLink*>, NoHook>;
+
+    ReadySink<Policy>* sink = nullptr;
+    std::coroutine_handle<> handle{};
+    // lock-free MPSC hook: atomic policies may be woken from another thread / signal handler
+    [[no_unique_address]] inbox_hook_t inbox_next{};
+    std::uint32_t sched_key = 0;
+    typename Policy::template block_t<bool> scheduled{false};
+    std::uint8_t sched_flags = 0;
+
+    // returns true if the caller became responsible for queueing the link
+    bool try_schedule() noexcept {
+        if constexpr (Policy::is_atomic) {
+            return !scheduled.exchange(true, std::memory_order_acq_rel);
+        } else {
+            if (scheduled) {
+                return false;
+            }
+            scheduled = true;
+            return true;
+        }
+    }
+
+    void release_schedule() noexcept {
+        if constexpr (Policy::is_atomic) {
+            scheduled.store(false, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        } else {
+            scheduled = false;
+        }
+    }
+
+    void detach() noexcept {
+        if (sink) {
+            sink->cancel(*sink, *this);
+            sink = nullptr;
+        }
+    }
+};
+
 /*
  * *******************************************************************
  *  Blocking mixin:
  *  if use_blocking==true — contains flag, block/unblock/is_blocked
+ *                          (and the ready link if use_scheduler_v)
  *  if use_blocking==false — empty
  * *******************************************************************
 */
@@ -23,10 +100,11 @@ template<class Policy>
 struct BlockingMixin<Policy, false> { };
 
 template<class Policy>
-struct BlockingMixin<Policy, true> {
+struct BlockingMixin<Policy, true> : std::conditional_t<use_scheduler_v<Policy>, ReadyLink<Policy>, NoHook> {
     typename Policy::template block_t<bool> waiting_for_event{false};
 
     void block() noexcept {
+        UCORO_TRACE_RECORD(Block, this, 0);
         if constexpr (Policy::is_atomic) {
             waiting_for_event.store(true, Policy::order);
         } else {
@@ -35,11 +113,20 @@ struct BlockingMixin<Policy, true> {
     }
 
     void unblock() noexcept {
+        UCORO_TRACE_RECORD(Unblock, this, 0);
         if constexpr (Policy::is_atomic) {
             waiting_for_event.store(false, Policy::order);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
         } else {
             waiting_for_event = false;
         }
+
+        // attached to a scheduler — hand the task over to its ready queue
+        if constexpr (use_scheduler_v<Policy>) {
+            if (this->sink && this->try_schedule()) {
+                this->sink->notify(*this->sink, *this);
+            }
+        }
     }
 
     bool is_blocked() const noexcept {
@@ -51,35 +138,274 @@ struct BlockingMixin<Policy, true> {
     }
 };
 
+template<class Policy>
+struct PromiseCore;
+
+/*
+ * *******************************************************************
+ *  Waker:
+ *  type-erased unblock() of a blocking promise — a plain function
+ *  pointer + target, no allocation. Used by timers/events to wake
+ *  the task that parked in them.
+ * *******************************************************************
+*/
+struct Waker {
+    void (*fn)(void*) noexcept = nullptr;
+    void* target = nullptr;
+
+    explicit operator bool() const noexcept { return fn != nullptr; }
+    void operator()() const noexcept { fn(target); }
+
+    template<class Promise>
+    static Waker of(Promise& promise) noexcept {
+        using core_t = PromiseCore<typename Promise::policy_t>;
+        static_assert(Promise::policy_t::use_blocking, "[UCORO]: Waker needs a blocking policy");
+        return Waker{ &wake<core_t>, static_cast<core_t*>(&promise) };
+    }
+
+private:
+    template<class Core>
+    static void wake(void* target) noexcept {
+        static_cast<Core*>(target)->unblock();
+    }
+};
+
+/*
+ * *******************************************************************
+ *  AwaitChain:
+ *  links of the await chain for `co_await child_task`:
+ *  - root: outermost frame, owns the blocking flag / ready link
+ *  - leaf: (root only) innermost frame, the one resume() must enter
+ *  - continuation: (child only) parent to transfer to at final_suspend
+ *  - on_finish: (blocking policies) called when this frame finishes,
+ *    used by when_all()/when_any()
+ *  Empty unless use_await_v<Policy>: every frame is then its own root
+ *  and leaf.
+ * *******************************************************************
+*/
+template<class Policy, bool = use_await_v<Policy>>
+struct AwaitChain { };
+
+template<class Policy>
+struct AwaitChain<Policy, true> {
+    PromiseCore<Policy>* root = nullptr;    // set by PromiseCore
+    std::coroutine_handle<> leaf{};
+    std::coroutine_handle<> continuation{};
+    [[no_unique_address]] std::conditional_t<Policy::use_blocking, Waker, NoHook> on_finish{};
+};
+
 /*
  * *******************************************************************
- *  PromiseBase with mixin
+ *  PromiseCore:
+ *  policy-only part of every promise (independent of the value type).
+ *  block()/unblock()/is_blocked() of any frame act on the root.
+ *  run() is the one place where a task chain is entered; instrumented
+ *  policies time it there (stats of the root).
+ * *******************************************************************
+*/
+template<class Policy>
+struct PromiseCore : BlockingMixin<Policy>, AwaitChain<Policy> {
+    using mixin_t = BlockingMixin<Policy>;
+
+    [[no_unique_address]] task_stats_t<Policy> stats{};
+
+    PromiseCore() noexcept {
+        if constexpr (use_await_v<Policy>) {
+            this->root = this;
+        }
+    }
+
+    // outermost frame of the chain this frame belongs to
+    PromiseCore& chain_root() noexcept {
+        if constexpr (use_await_v<Policy>) {
+            return *this->root;
+        } else {
+            return *this;
+        }
+    }
+
+    const PromiseCore& chain_root() const noexcept {
+        return const_cast<PromiseCore*>(this)->chain_root();
+    }
+
+    void block() noexcept requires Policy::use_blocking { chain_root().mixin_t::block(); }
+    void unblock() noexcept requires Policy::use_blocking { chain_root().mixin_t::unblock(); }
+    bool is_blocked() const noexcept requires Policy::use_blocking { return chain_root().mixin_t::is_blocked(); }
+
+    // frame to enter when the chain rooted here is resumed (`self`: this frame)
+    std::coroutine_handle<> resume_point(std::coroutine_handle<> self) const noexcept {
+        if constexpr (use_await_v<Policy>) {
+            return this->root->leaf;
+        } else {
+            return self;
+        }
+    }
+
+    // resume the chain rooted here; `self` is the handle of this frame
+    void run(std::coroutine_handle<> self) noexcept {
+        UCORO_TRACE_RECORD(Resume, &chain_root(), 0);
+        if constexpr (use_stats_v<Policy>) {
+            auto& s = chain_root().stats;
+            const auto start = s.begin_run();
+            resume_point(self).resume();
+            if constexpr (Policy::use_blocking) {
+                s.end_run(start, is_blocked());
+            } else {
+                s.end_run(start, false);
+            }
+        } else {
+            resume_point(self).resume();
+        }
+        UCORO_TRACE_RECORD(Suspend, &chain_root(), resume_point(self).done());
+    }
+
+    // ready link handed out by a scheduler -> its promise core
+    static PromiseCore& from_link(ReadyLink<Policy>& link) noexcept requires use_scheduler_v<Policy> {
+        return static_cast<PromiseCore&>(static_cast<mixin_t&>(link));
+    }
+};
+
+/*
+ * *******************************************************************
+ *  FinalAwaiter:
+ *  child frame finished — hand control straight to the awaiting
+ *  parent (symmetric transfer, no trip through the scheduler),
+ *  otherwise stay suspended like std::suspend_always.
+ * *******************************************************************
+*/
+struct FinalAwaiter {
+    constexpr bool await_ready() const noexcept { return false; }
+
+    template<class Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        if constexpr (use_await_v<typename Promise::policy_t>) {
+            auto& promise = h.promise();
+            if constexpr (Promise::policy_t::use_blocking) {
+                if (promise.on_finish) {
+                    promise.on_finish();
+                }
+            }
+            if (promise.continuation) {
+                promise.root->leaf = promise.continuation;
+                return promise.continuation;
+            }
+        }
+        return std::noop_coroutine();
+    }
+
+    constexpr void await_resume() const noexcept {}
+};
+
+/*
+ * *******************************************************************
+ *  Frame allocation through the policy frame_allocator
+ *  (HeapFrameAllocator unless the policy says otherwise)
+ * *******************************************************************
+*/
+template<class Policy>
+struct PromiseAllocator {
+    static void* operator new(std::size_t size) noexcept {
+        return frame_allocator_t<Policy>::allocate(size);
+    }
+
+    static void operator delete(void* ptr, std::size_t size) noexcept {
+        frame_allocator_t<Policy>::deallocate(ptr, size);
+    }
+};
+
+/*
+ * *******************************************************************
+ *  Error storage of a promise, type chosen by the policy
+ *  (std::exception_ptr by default, see CompactPolicy)
+ * *******************************************************************
+*/
+template<class Policy>
+struct PromiseError {
+    using error_t = ucoro::error_t<Policy>;
+
+    [[no_unique_address]] error_t error{};
+
+    void unhandled_exception() noexcept {
+        if constexpr (std::is_same_v<error_t, std::exception_ptr>) {
+            error = std::current_exception();
+        } else if constexpr (std::is_same_v<error_t, NoError>) {
+            std::terminate();
+        } else {
+            static_assert(error_code_v<error_t>,
+                          "[UCORO]: error_type must be an integral or an enum type with a fixed underlying type");
+            error = static_cast<error_t>(-1);
+        }
+    }
+
+    bool has_error() const noexcept {
+        if constexpr (std::is_same_v<error_t, NoError>) {
+            return false;
+        } else {
+            return error != error_t{};
+        }
+    }
+};
+
+/*
+ * *******************************************************************
+ *  fail(code):
+ *  `co_await ucoro::fail(code);` records an error code in a task with
+ *  a code-type CompactPolicy and carries on (does not suspend)
+ * *******************************************************************
+*/
+template<class Error>
+struct FailAwaiter {
+    Error code;
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    template<class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        static_assert(std::is_convertible_v<Error, typename Promise::error_t>
+                      && !std::is_same_v<typename Promise::error_t, std::exception_ptr>
+                      && !std::is_same_v<typename Promise::error_t, NoError>,
+                      "[UCORO]: fail() needs a CompactPolicy with an error code type");
+        h.promise().error = static_cast<typename Promise::error_t>(code);
+        return false;
+    }
+
+    constexpr void await_resume() const noexcept {}
+};
+
+template<class Error>
+FailAwaiter<Error> fail(Error code) noexcept {
+    return {code};
+}
+
+/*
+ * *******************************************************************
+ *  PromiseBase with mixins
  * *******************************************************************
 */
 template<class TaskT, class Policy = default_policy>
 struct PromiseBase
-    : BlockingMixin<Policy>
+    : PromiseAllocator<Policy>
+    , PromiseCore<Policy>
+    , PromiseError<Policy>
 {
     using policy_t = Policy;
     using task_t = Policy;
-    std::exception_ptr error{};
 
     constexpr std::suspend_always initial_suspend() noexcept { return {}; }
-    constexpr std::suspend_always final_suspend()   noexcept { return {}; }
-
-    void unhandled_exception() noexcept {
-        error = std::current_exception();
-    }
+    constexpr FinalAwaiter        final_suspend()   noexcept { return {}; }
 
     TaskT get_return_object() noexcept {
-        return TaskT{
-            TaskT::coro_t::from_promise(static_cast<typename TaskT::promise_type&>(*this))
-        };
+        auto h = TaskT::coro_t::from_promise(static_cast<typename TaskT::promise_type&>(*this));
+        if constexpr (use_await_v<Policy>) {
+            this->leaf = h;
+        }
+        return TaskT{h};
     }
 
-//    [[noreturn]] static TaskT get_return_object_on_allocation_failure() {
-//        throw std::bad_alloc();
-//    }
+    // frame allocation failed — hand out an invalid (empty) task, never throw
+    static TaskT get_return_object_on_allocation_failure() noexcept {
+        return TaskT{};
+    }
 };
 
 }
@@ -0,0 +1,360 @@
+#ifndef CORO_SCHEDULER_H
+#define CORO_SCHEDULER_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+#include "u_coro.h"
+
+namespace ucoro {
+
+/*
+ * *******************************************************************
+ *  ReadyQueue:
+ *  intrusive FIFO of ReadyLink (circular list with a sentinel),
+ *  O(1) push / pop / remove, no allocation
+ * *******************************************************************
+*/
+template<class Policy>
+class ReadyQueue {
+public:
+    using link_t = ReadyLink<Policy>;
+
+    ReadyQueue() noexcept { head.next = head.prev = &head; }
+    ReadyQueue(const ReadyQueue&) = delete;
+    ReadyQueue& operator=(const ReadyQueue&) = delete;
+
+    bool empty() const noexcept { return head.next == &head; }
+    std::size_t size() const noexcept { return count; }
+
+    void push(link_t& link) noexcept {
+        ReadyHook* tail = head.prev;
+        link.prev = tail;
+        link.next = &head;
+        tail->next = &link;
+        head.prev = &link;
+        ++count;
+    }
+
+    link_t* pop() noexcept {
+        if (empty()) {
+            return nullptr;
+        }
+        ReadyHook* first = head.next;
+        unlink(*first);
+        return static_cast<link_t*>(first);
+    }
+
+    void remove(link_t& link) noexcept {
+        if (link.linked()) {
+            unlink(link);
+        }
+    }
+
+private:
+    void unlink(ReadyHook& node) noexcept {
+        node.prev->next = node.next;
+        node.next->prev = node.prev;
+        node.next = node.prev = nullptr;
+        --count;
+    }
+
+    ReadyHook head{};
+    std::size_t count = 0;
+};
+
+/*
+ * *******************************************************************
+ *  MpscReadyQueue:
+ *  intrusive lock-free multi-producer / single-consumer queue
+ *  (D. Vyukov). push() is wait-free — two atomic ops, no locks — so
+ *  it may run in another thread or in a signal handler / ISR.
+ *  pop() belongs to the owning scheduler only.
+ * *******************************************************************
+*/
+template<class Policy>
+class MpscReadyQueue {
+    static_assert(Policy::is_atomic, "[UCORO]: MpscReadyQueue needs an atomic policy");
+
+public:
+    using link_t = ReadyLink<Policy>;
+
+    MpscReadyQueue() noexcept = default;
+    MpscReadyQueue(const MpscReadyQueue&) = delete;
+    MpscReadyQueue& operator=(const MpscReadyQueue&) = delete;
+
+    void push(link_t& link) noexcept {
+        link.inbox_next.store(nullptr, std::memory_order_relaxed);
+        link_t* prev = head.exchange(&link, std::memory_order_acq_rel);
+        prev->inbox_next.store(&link, std::memory_order_release);
+    }
+
+    // nullptr when empty or when a producer is between its two steps
+    link_t* pop() noexcept {
+        link_t* first = tail;
+        link_t* next = first->inbox_next.load(std::memory_order_acquire);
+
+        if (first == &stub) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            tail = next;
+            first = next;
+            next = next->inbox_next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr) {
+            tail = next;
+            return first;
+        }
+
+        if (first != head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        push(stub);
+        next = first->inbox_next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail = next;
+            return first;
+        }
+        return nullptr;
+    }
+
+    bool empty() const noexcept {
+        return tail == &stub && stub.inbox_next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    link_t stub{};
+    std::atomic<link_t*> head{&stub};
+    link_t* tail = &stub;
+};
+
+/*
+ * *******************************************************************
+ *  BasicScheduler:
+ *  common core of Scheduler, PriorityScheduler and EdfScheduler
+ *  (CRTP): the ReadySink callbacks, the MPSC inbox of atomic policies,
+ *  the step of one task and the run loops. Derived keeps the ready
+ *  structure and provides (may be private, befriend BasicScheduler):
+ *   - void push(link_t&)        queue a runnable link
+ *   - link_t* pop_next()        next link to run, nullptr if none
+ *   - void remove(link_t&)      unqueue a linked() link
+ *   - std::size_t ready_count() const
+ *   - void run_link(link_t&)    optional, resumes the task (accounting)
+ * *******************************************************************
+*/
+template<class Derived, class Policy>
+class BasicScheduler : private ReadySink<Policy> {
+    static_assert(use_scheduler_v<Policy>, "[UCORO]: schedulers need a blocking policy with use_scheduler");
+
+public:
+    using link_t = ReadyLink<Policy>;
+
+    BasicScheduler(const BasicScheduler&) = delete;
+    BasicScheduler& operator=(const BasicScheduler&) = delete;
+
+    // run the next ready task (in the order of the derived scheduler); false if none was ready
+    bool run_next() noexcept {
+        if constexpr (Policy::is_atomic) {
+            drain_inbox();
+        }
+
+        link_t* link = derived().pop_next();
+        if (link == nullptr) {
+            return false;
+        }
+        step(*link);
+        return true;
+    }
+
+    // resume every task that was ready when the pass started, returns how many ran
+    std::size_t run_once() noexcept {
+        if constexpr (Policy::is_atomic) {
+            drain_inbox();
+        }
+
+        std::size_t budget = derived().ready_count();
+        std::size_t ran = 0;
+
+        while (budget-- != 0) {
+            link_t* link = derived().pop_next();
+            if (link == nullptr) {
+                break;
+            }
+            step(*link);
+            ++ran;
+        }
+        return ran;
+    }
+
+    std::size_t active() const noexcept { return attached; }     // attached, not finished
+
+    bool idle() const noexcept {
+        if constexpr (Policy::is_atomic) {
+            return derived().ready_count() == 0 && inbox.empty();
+        } else {
+            return derived().ready_count() == 0;
+        }
+    }
+
+    // atomic policies: called after unblock() from another context queued a task (e.g. IdleSignal::waker());
+    // set it before tasks run
+    void set_wake_hook(Waker hook) noexcept { wake_hook = hook; }
+
+protected:
+    BasicScheduler() noexcept
+        : ReadySink<Policy>{&BasicScheduler::on_notify, &BasicScheduler::on_cancel, &BasicScheduler::on_attach} {}
+
+    // link of a task that may be attached (valid, not finished, not attached elsewhere), handle set
+    template<class T>
+    static link_t* claim(Task<T, Policy>& task) noexcept {
+        if (task.done()) {
+            return nullptr;
+        }
+
+        link_t& link = task.handle().promise();
+        if (link.sink != nullptr) {
+            return nullptr;
+        }
+
+        link.handle = task.handle();
+        return &link;
+    }
+
+    void attach(link_t& link) noexcept { on_attach(*this, link); }
+
+    void run_link(link_t& link) noexcept { PromiseCore<Policy>::from_link(link).run(link.handle); }
+
+private:
+    Derived& derived() noexcept { return static_cast<Derived&>(*this); }
+    const Derived& derived() const noexcept { return static_cast<const Derived&>(*this); }
+
+    void step(link_t& link) noexcept {
+        derived().run_link(link);
+
+        if (link.handle.done()) {
+            link.sink = nullptr;
+            link.release_schedule();
+            --attached;
+            return;
+        }
+
+        // yielded — back to the ready structure; blocked — wait for unblock()
+        link.release_schedule();
+        if (!static_cast<BlockingMixin<Policy>&>(link).is_blocked() && link.try_schedule()) {
+            derived().push(link);
+        }
+    }
+
+    void drain_inbox() noexcept {
+        while (link_t* link = inbox.pop()) {
+            derived().push(*link);
+        }
+    }
+
+    // may run in any context for atomic policies, owner context otherwise
+    static void on_notify(ReadySink<Policy>& sink, link_t& link) noexcept {
+        auto& self = static_cast<BasicScheduler&>(sink);
+        if constexpr (Policy::is_atomic) {
+            self.inbox.push(link);
+            if (self.wake_hook) {
+                self.wake_hook();
+            }
+        } else {
+            self.derived().push(link);
+        }
+    }
+
+    // owner context only (spawn(), or a running task handing over a child)
+    static void on_attach(ReadySink<Policy>& sink, link_t& link) noexcept {
+        auto& self = static_cast<BasicScheduler&>(sink);
+        link.sink = &self;
+        ++self.attached;
+
+        if (!static_cast<BlockingMixin<Policy>&>(link).is_blocked() && link.try_schedule()) {
+            self.derived().push(link);
+        }
+    }
+
+    // owner context only (the Task is being destroyed)
+    static void on_cancel(ReadySink<Policy>& sink, link_t& link) noexcept {
+        auto& self = static_cast<BasicScheduler&>(sink);
+        if constexpr (Policy::is_atomic) {
+            // take the schedule flag so a late unblock() (another thread, a signal handler) cannot queue
+            // the link any more; if it is taken, the link is queued and may still sit in the inbox
+            // (or be half-pushed) — pull it out first
+            if (!link.try_schedule()) {
+                while (!link.linked()) {
+                    self.drain_inbox();
+                }
+            }
+        }
+        if (link.linked()) {
+            self.derived().remove(link);
+        }
+        --self.attached;
+    }
+
+    using inbox_t = std::conditional_t<Policy::is_atomic, MpscReadyQueue<Policy>, NoHook>;
+
+    [[no_unique_address]] inbox_t inbox{};
+    Waker wake_hook{};
+    std::size_t attached = 0;
+};
+
+/*
+ * *******************************************************************
+ *  Scheduler:
+ *  drives attached tasks from a ready queue. A task that blocks is
+ *  simply not requeued; its unblock() pushes it back, so one pass
+ *  costs O(ready tasks), not O(all tasks).
+ *  Tasks stay owned by the caller; destroying a Task detaches it.
+ *  With an atomic policy unblock() may come from another thread or a
+ *  signal handler: woken links land in a lock-free MPSC inbox that
+ *  run_once() drains. Other policies: unblock() from the owner only.
+ *  NOTE: do not call Task::resume() on an attached task.
+ *
+ *  ucoro::Scheduler<ucoro::PlainPolicy> sched;
+ *  auto t = blink_led();
+ *  sched.spawn(t);
+ *  while (sched.active()) { sched.run_once(); }
+ * *******************************************************************
+*/
+template<class Policy>
+class Scheduler : public BasicScheduler<Scheduler<Policy>, Policy> {
+    using base_t = BasicScheduler<Scheduler<Policy>, Policy>;
+    friend base_t;
+
+public:
+    using link_t = ReadyLink<Policy>;
+
+    Scheduler() noexcept = default;
+
+    // attach task; returns false if it is invalid, finished or attached elsewhere
+    template<class T>
+    bool spawn(Task<T, Policy>& task) noexcept {
+        link_t* link = base_t::claim(task);
+        if (link == nullptr) {
+            return false;
+        }
+        this->attach(*link);
+        return true;
+    }
+
+    std::size_t ready_count() const noexcept { return ready.size(); }
+
+private:
+    void push(link_t& link) noexcept { ready.push(link); }
+    link_t* pop_next() noexcept { return ready.pop(); }
+    void remove(link_t& link) noexcept { ready.remove(link); }
+
+    ReadyQueue<Policy> ready{};
+};
+
+} /* namespace ucoro */
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_SCHEDULER_H
@@ -0,0 +1,208 @@
+#ifndef CORO_STATS_H
+#define CORO_STATS_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace ucoro {
+
+// hosted default clock: nanoseconds of std::chrono::steady_clock
+struct SteadyStatsClock {
+    static std::uint64_t now() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+template<class Clock>
+class StatsRegistry;
+
+/*
+ * *******************************************************************
+ *  TaskStats:
+ *  per-task counters kept by instrumented policies. Updated by
+ *  whoever resumes the task (TaskBase::resume(), Scheduler, ...):
+ *  - resumes            : number of resumes
+ *  - run_total/run_max  : time between resume and the next suspension
+ *  - blocked_total      : time from a blocking suspension to the next
+ *                         resume (includes the wait in the ready queue)
+ *  - histogram[i]       : runs of [2^(i-1), 2^i) ticks, last bucket open
+ *  All times are in Clock ticks.
+ * *******************************************************************
+*/
+template<class Clock>
+struct TaskStats {
+    using tick_t = decltype(Clock::now());
+
+    static constexpr std::size_t buckets = 16;
+
+    const char* name = nullptr;     // optional, set by the user for dumps
+    std::uint32_t resumes = 0;
+    tick_t run_total = 0;
+    tick_t run_max = 0;
+    tick_t blocked_total = 0;
+    std::uint32_t histogram[buckets]{};
+
+    TaskStats() noexcept = default;
+    TaskStats(const TaskStats&) = delete;
+    TaskStats& operator=(const TaskStats&) = delete;
+    ~TaskStats() { StatsRegistry<Clock>::remove(*this); }
+
+    tick_t begin_run() noexcept {
+        const tick_t start = Clock::now();
+        if (!linked) {
+            StatsRegistry<Clock>::add(*this);
+        }
+        if (parked) {
+            blocked_total += start - parked_at;
+            parked = false;
+        }
+        return start;
+    }
+
+    void end_run(tick_t start, bool blocked) noexcept {
+        const tick_t stop = Clock::now();
+        const tick_t run = stop - start;
+
+        ++resumes;
+        run_total += run;
+        if (run > run_max) {
+            run_max = run;
+        }
+        const std::size_t bucket = static_cast<std::size_t>(std::bit_width(run));
+        ++histogram[bucket < buckets ? bucket : buckets - 1];
+
+        if (blocked) {
+            parked = true;
+            parked_at = stop;
+        }
+    }
+
+private:
+    friend class StatsRegistry<Clock>;
+
+    TaskStats* next = nullptr;
+    TaskStats* prev = nullptr;
+    bool linked = false;
+    bool parked = false;
+    tick_t parked_at = 0;
+};
+
+/*
+ * *******************************************************************
+ *  StatsRegistry:
+ *  list of every live task that has run at least once, one list per
+ *  clock type. Tasks join on their first resume and leave when their
+ *  frame is destroyed. The list itself is guarded by a spin lock
+ *  (tasks may first run on any WorkStealingExecutor worker), taken
+ *  once per task and by for_each / count / dump; values of tasks
+ *  running elsewhere may still be torn.
+ *  NOTE: do not destroy tasks from inside for_each().
+ *
+ *  ucoro::StatsRegistry<ucoro::SteadyStatsClock>::dump(stdout);
+ * *******************************************************************
+*/
+template<class Clock>
+class StatsRegistry {
+public:
+    using stats_t = TaskStats<Clock>;
+
+    template<class F>
+    static void for_each(F&& fn) {
+        lock();
+        for (stats_t* s = head; s != nullptr; s = s->next) {
+            fn(static_cast<const stats_t&>(*s));
+        }
+        unlock();
+    }
+
+    static std::size_t count() noexcept {
+        lock();
+        std::size_t n = 0;
+        for (stats_t* s = head; s != nullptr; s = s->next) {
+            ++n;
+        }
+        unlock();
+        return n;
+    }
+
+    // one line per task: name resumes run_total run_max blocked_total
+    static void dump(std::FILE* out) {
+        std::fprintf(out, "%-20s %10s %14s %14s %14s\n", "task", "resumes", "run_total", "run_max", "blocked_total");
+        for_each([out](const stats_t& s) {
+            std::fprintf(out, "%-20s %10lu %14llu %14llu %14llu\n",
+                         s.name ? s.name : "?",
+                         static_cast<unsigned long>(s.resumes),
+                         static_cast<unsigned long long>(s.run_total),
+                         static_cast<unsigned long long>(s.run_max),
+                         static_cast<unsigned long long>(s.blocked_total));
+        });
+    }
+
+private:
+    friend stats_t;
+
+    static void add(stats_t& s) noexcept {
+        lock();
+        s.prev = nullptr;
+        s.next = head;
+        if (head) {
+            head->prev = &s;
+        }
+        head = &s;
+        s.linked = true;
+        unlock();
+    }
+
+    // frame destruction: the task does not run, so `linked` is stable here
+    static void remove(stats_t& s) noexcept {
+        if (!s.linked) {
+            return;
+        }
+        lock();
+        (s.prev ? s.prev->next : head) = s.next;
+        if (s.next) {
+            s.next->prev = s.prev;
+        }
+        s.next = s.prev = nullptr;
+        s.linked = false;
+        unlock();
+    }
+
+    static void lock() noexcept {
+        while (guard.test_and_set(std::memory_order_acquire)) {
+        }
+    }
+
+    static void unlock() noexcept { guard.clear(std::memory_order_release); }
+
+    inline static stats_t* head = nullptr;
+    inline static std::atomic_flag guard = ATOMIC_FLAG_INIT;
+};
+
+struct NoStats { };
+
+template<class Policy, class Clock = typename policy_stats_clock<Policy>::type>
+struct policy_stats {
+    using type = TaskStats<Clock>;
+};
+
+template<class Policy>
+struct policy_stats<Policy, void> {
+    using type = NoStats;
+};
+
+template<class Policy>
+using task_stats_t = typename policy_stats<Policy>::type;
+
+} /* namespace ucoro */
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_STATS_H
@@ -23,7 +23,7 @@ public:
     TaskBase& operator=(TaskBase&& o) noexcept {
         if (this != &o) {
             if (coro) {
-                coro.destroy();
+                release();
             }
             coro = std::exchange(o.coro, nullptr);
         }
@@ -32,14 +32,19 @@ public:
 
     ~TaskBase() {
         if (coro) {
-            coro.destroy();
+            release();
         }
     }
 
     bool is_valid() const noexcept { return coro != nullptr; }
     bool done() const noexcept { return is_valid() ? coro.done() : true; }
-    bool has_error() const noexcept { return is_valid() && coro.promise().error; }
-    std::exception_ptr get_error() const noexcept { return is_valid() ? coro.promise().error : nullptr; }
+    bool has_error() const noexcept { return is_valid() && coro.promise().has_error(); }
+    // std::exception_ptr, error code or NoError — see the policy error_type
+    auto get_error() const noexcept { return is_valid() ? coro.promise().error : typename Promise::error_t{}; }
+    coro_t handle() const noexcept { return coro; }
+
+    // instrumented policies only (see coro_stats.h); the task must be valid
+    auto& stats() noexcept requires use_stats_v<typename Promise::policy_t> { return coro.promise().stats; }
 
     bool resume() noexcept {
         // if the handle is empty or already at the end — do nothing
@@ -54,18 +59,85 @@ public:
             }
         }
 
-        // otherwise wake up
-        coro.resume();
+        // otherwise wake up (the innermost awaited child, if any)
+        coro.promise().run(coro);
 
         // return whether it is not finished yet
         return !coro.done();
     }
 
 
+    auto operator co_await() & noexcept;
+    auto operator co_await() && noexcept;
+
 protected:
     coro_t coro = nullptr;
+
+private:
+    void release() noexcept {
+        if constexpr (use_scheduler_v<typename Promise::policy_t>) {
+            // drop out of the scheduler before the frame disappears
+            coro.promise().detach();
+        }
+        coro.destroy();
+    }
+};
+
+
+/*
+ * *******************************************************************
+ *  TaskAwaiter:
+ *  `co_await child` from another task of the same policy. The child
+ *  joins the parent's chain (blocking acts on the outermost task) and
+ *  is entered directly via symmetric transfer; when it finishes its
+ *  FinalAwaiter transfers straight back, so nesting depth costs no
+ *  stack and no scheduler round trip.
+ * *******************************************************************
+*/
+template<class Promise>
+struct TaskAwaiter {
+    std::coroutine_handle<Promise> child;
+
+    bool await_ready() const noexcept { return !child || child.done(); }
+
+    template<class ParentPromise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<ParentPromise> parent) noexcept {
+        static_assert(std::is_same_v<typename ParentPromise::policy_t, typename Promise::policy_t>,
+                      "[UCORO]: co_await of a Task requires the same policy in parent and child");
+        static_assert(use_await_v<typename Promise::policy_t>, "[UCORO]: co_await of a Task needs a policy with use_await");
+
+        auto& promise = child.promise();
+        promise.continuation = parent;
+        promise.root = parent.promise().root;
+        promise.root->leaf = child;
+        return child;
+    }
+
+    decltype(auto) await_resume() const {
+        if (!child) {
+            return Promise::empty_result();
+        }
+        auto& promise = child.promise();
+#if defined(__cpp_exceptions)
+        if constexpr (std::is_same_v<typename Promise::error_t, std::exception_ptr>) {
+            if (promise.error) {
+                std::rethrow_exception(promise.error);
+            }
+        }
+#endif
+        return promise.result();
+    }
 };
 
+template<class Promise>
+auto TaskBase<Promise>::operator co_await() & noexcept {
+    return TaskAwaiter<Promise>{coro};
+}
+
+template<class Promise>
+auto TaskBase<Promise>::operator co_await() && noexcept {
+    return TaskAwaiter<Promise>{coro};
+}
 
 } /* namespace coro */
 
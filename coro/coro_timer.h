@@ -0,0 +1,268 @@
+#ifndef CORO_TIMER_H
+#define CORO_TIMER_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+#include "coro_promise.h"
+#include <cstdint>
+
+namespace ucoro {
+
+// wheel time unit is whatever the application feeds into advance() (usually ms)
+using tick_t = std::uint32_t;
+
+/*
+ * *******************************************************************
+ *  TimerNode:
+ *  intrusive timer, lives inside the awaitable (i.e. coroutine frame)
+ * *******************************************************************
+*/
+struct TimerNode {
+    TimerNode* next = nullptr;
+    TimerNode* prev = nullptr;
+    tick_t expires = 0;
+    void (*fire)(TimerNode&) noexcept = nullptr;
+
+    bool linked() const noexcept { return prev != nullptr; }
+};
+
+/*
+ * *******************************************************************
+ *  TimerWheel:
+ *  hierarchical timing wheel, Levels x 2^SlotBits slots.
+ *  schedule/cancel O(1), expiry O(1) amortized (each timer cascades
+ *  at most Levels-1 times). Range: 2^(Levels*SlotBits) ticks, longer
+ *  timers are parked in the top level and re-cascaded.
+ *  NOTE: single context — call schedule/cancel/advance from one place.
+ * *******************************************************************
+*/
+template<unsigned Levels = 4, unsigned SlotBits = 6>
+class TimerWheel {
+    static_assert(Levels > 0 && SlotBits > 0, "[UCORO]: empty timer wheel");
+    static_assert(Levels * SlotBits < 32, "[UCORO]: timer wheel range exceeds tick_t");
+
+    static constexpr tick_t slots = tick_t(1) << SlotBits;
+    static constexpr tick_t mask = slots - 1;
+
+public:
+    static constexpr tick_t max_delay = (tick_t(1) << (Levels * SlotBits)) - 1;
+
+    TimerWheel() noexcept {
+        for (auto& level : wheel) {
+            for (auto& head : level) {
+                head.next = head.prev = &head;
+            }
+        }
+    }
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    tick_t now() const noexcept { return current; }
+    std::size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+
+    // expires <= now() fires on the next advance()
+    void schedule(TimerNode& node, tick_t expires) noexcept {
+        cancel(node);
+        node.expires = expires;
+        insert(node, 1);
+        ++count;
+    }
+
+    void cancel(TimerNode& node) noexcept {
+        if (node.linked()) {
+            unlink(node);
+            --count;
+        }
+    }
+
+    // move wheel time forward to `to`, firing everything that expired; returns fired count
+    std::size_t advance(tick_t to) noexcept {
+        std::size_t fired = 0;
+
+        while (static_cast<std::int32_t>(to - current) > 0) {
+            if (count == 0) {
+                current = to;   // nothing to do in between — jump
+                break;
+            }
+
+            ++current;
+            cascade(1);
+
+            TimerNode& head = wheel[0][current & mask];
+            while (head.next != &head) {
+                TimerNode* node = head.next;
+                unlink(*node);
+                --count;
+                ++fired;
+                node->fire(*node);
+            }
+        }
+        return fired;
+    }
+
+    // lower bound of the next expiry: exact for level 0 (slot = tick); for upper levels the
+    // earliest timer of their first occupied slot. Minimum over all levels.
+    bool next_expiry(tick_t& out) const noexcept {
+        if (count == 0) {
+            return false;
+        }
+        bool found = false;
+        tick_t best = 0;
+        for (unsigned level = 0; level < Levels; ++level) {
+            const unsigned shift = level * SlotBits;
+            const tick_t base = current >> shift;
+            for (tick_t i = 1; i <= slots; ++i) {
+                const tick_t start = level == 0 ? current + i : (base + i) << shift;
+                if (found && static_cast<std::int32_t>(start - best) >= 0) {
+                    break;      // nothing further up this level can be earlier
+                }
+                const TimerNode& head = wheel[level][(base + i) & mask];
+                if (head.next != &head) {
+                    const tick_t when = level == 0 ? start : earliest(head, start);
+                    if (!found || static_cast<std::int32_t>(when - best) < 0) {
+                        best = when;
+                        found = true;
+                    }
+                    break;
+                }
+            }
+        }
+        out = found ? best : current + max_delay;
+        return true;
+    }
+
+private:
+    // min_delta: 1 for new timers (current slot is already processed), 0 while cascading
+    void insert(TimerNode& node, tick_t min_delta) noexcept {
+        const auto signed_delta = static_cast<std::int32_t>(node.expires - current);
+        tick_t delta = signed_delta < static_cast<std::int32_t>(min_delta) ? min_delta : static_cast<tick_t>(signed_delta);
+        tick_t when = current + delta;
+
+        if (delta > max_delay) {
+            delta = max_delay;
+            when = current + max_delay;
+        }
+
+        unsigned level = 0;
+        while (level + 1 < Levels && delta >= (tick_t(1) << ((level + 1) * SlotBits))) {
+            ++level;
+        }
+
+        TimerNode& head = wheel[level][(when >> (level * SlotBits)) & mask];
+        node.prev = head.prev;
+        node.next = &head;
+        head.prev->next = &node;
+        head.prev = &node;
+    }
+
+    // earliest expiry in an upper-level slot, never before the slot starts
+    static tick_t earliest(const TimerNode& head, tick_t start) noexcept {
+        tick_t when = head.next->expires;
+        for (const TimerNode* node = head.next->next; node != &head; node = node->next) {
+            if (static_cast<std::int32_t>(node->expires - when) < 0) {
+                when = node->expires;
+            }
+        }
+        return static_cast<std::int32_t>(when - start) < 0 ? start : when;
+    }
+
+    static void unlink(TimerNode& node) noexcept {
+        node.prev->next = node.next;
+        node.next->prev = node.prev;
+        node.next = node.prev = nullptr;
+    }
+
+    // on level boundary pull the matching upper slot down one level
+    void cascade(unsigned level) noexcept {
+        if (level >= Levels || (current & ((tick_t(1) << (level * SlotBits)) - 1)) != 0) {
+            return;
+        }
+        cascade(level + 1);
+
+        TimerNode& head = wheel[level][(current >> (level * SlotBits)) & mask];
+        TimerNode* node = head.next;
+        head.next = head.prev = &head;
+
+        while (node != &head) {
+            TimerNode* next = node->next;
+            insert(*node, 0);
+            node = next;
+        }
+    }
+
+    TimerNode wheel[Levels][slots]{};
+    tick_t current = 0;
+    std::size_t count = 0;
+};
+
+using default_timer_wheel = TimerWheel<>;
+
+// global wheel used by sleep_for / sleep_until without an explicit wheel
+inline default_timer_wheel timer_wheel;
+
+/*
+ * *******************************************************************
+ *  SleepAwaitable:
+ *  parks the task (block()) until the wheel fires; nothing resumes it
+ *  in between. Destroying the frame while asleep cancels the timer.
+ * *******************************************************************
+*/
+template<class Wheel>
+struct SleepAwaitable : private TimerNode {
+    Wheel& wheel;
+    tick_t deadline;
+    Waker waker{};
+
+    SleepAwaitable(Wheel& w, tick_t until) noexcept : wheel(w), deadline(until) {}
+    SleepAwaitable(const SleepAwaitable&) = delete;
+    SleepAwaitable& operator=(const SleepAwaitable&) = delete;
+
+    ~SleepAwaitable() { wheel.cancel(*this); }
+
+    bool await_ready() const noexcept {
+        return static_cast<std::int32_t>(deadline - wheel.now()) <= 0;
+    }
+
+    template<class Promise>
+    void await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        static_assert(Promise::policy_t::use_blocking, "You must use blocking type Task");
+
+        h.promise().block();
+        waker = Waker::of(h.promise());
+        fire = &SleepAwaitable::on_fire;
+        wheel.schedule(*this, deadline);
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    static void on_fire(TimerNode& node) noexcept {
+        static_cast<SleepAwaitable&>(node).waker();
+    }
+};
+
+template<class Wheel>
+SleepAwaitable<Wheel> sleep_until(Wheel& wheel, tick_t deadline) noexcept {
+    return {wheel, deadline};
+}
+
+template<class Wheel>
+SleepAwaitable<Wheel> sleep_for(Wheel& wheel, tick_t delay) noexcept {
+    return {wheel, wheel.now() + delay};
+}
+
+inline SleepAwaitable<default_timer_wheel> sleep_until(tick_t deadline) noexcept {
+    return {timer_wheel, deadline};
+}
+
+inline SleepAwaitable<default_timer_wheel> sleep_for(tick_t delay) noexcept {
+    return {timer_wheel, timer_wheel.now() + delay};
+}
+
+} /* namespace ucoro */
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_TIMER_H
@@ -0,0 +1,183 @@
+#ifndef CORO_TRACE_H
+#define CORO_TRACE_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+/*
+ * *******************************************************************
+ *  Build switches:
+ *  UCORO_TRACE           — 1: record scheduling events (default 0, no code)
+ *  UCORO_TRACE_CAPACITY  — records kept, power of two (default 1024)
+ *  UCORO_TRACE_CLOCK()   — uint32_t timestamp, microseconds by default;
+ *                          on a MCU e.g. a free-running timer counter
+ * *******************************************************************
+*/
+#ifndef UCORO_TRACE
+#   define UCORO_TRACE 0
+#endif
+
+#ifndef UCORO_TRACE_CAPACITY
+#   define UCORO_TRACE_CAPACITY 1024
+#endif
+
+#ifndef UCORO_TRACE_CLOCK
+#   define UCORO_TRACE_CLOCK() static_cast<std::uint32_t>(                          \
+        std::chrono::duration_cast<std::chrono::microseconds>(                      \
+            std::chrono::steady_clock::now().time_since_epoch()).count())
+#endif
+
+namespace ucoro {
+
+enum class TraceKind : std::uint16_t {
+    Resume = 1,     // task: entering the chain
+    Suspend,        // task: back from it, arg: 1 — finished
+    Block,          // task: block()
+    Unblock,        // task: unblock() (any context)
+    EventPend,      // arg: event index
+    EventPost,      // arg: event index (from ISR / signal / other thread)
+};
+
+/*
+ * *******************************************************************
+ *  TraceBuffer:
+ *  fixed-size ring of trace records, oldest records are overwritten.
+ *  record() is lock-free (one fetch_add + relaxed stores), so it may
+ *  run from any thread or ISR. Each slot carries the sequence number
+ *  of its record; a reader keeps only slots whose sequence did not
+ *  change while they were copied.
+ * *******************************************************************
+*/
+struct TraceRecord {
+    std::uint32_t seq;
+    std::uint32_t time;
+    TraceKind kind;
+    std::uint16_t arg;
+    std::uintptr_t task;    // address of the root promise, 0 if none
+};
+
+template<std::size_t Capacity>
+class TraceBuffer {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "[UCORO]: TraceBuffer capacity must be a power of two");
+
+public:
+    void record(TraceKind kind, const void* task, std::uint16_t arg) noexcept {
+        const std::uint32_t n = head.fetch_add(1, std::memory_order_relaxed);
+        Slot& s = slots[n & mask];
+        s.seq.store(0, std::memory_order_relaxed);              // being written
+        std::atomic_thread_fence(std::memory_order_release);    // pairs with the acquire fence in snapshot()
+        s.time.store(UCORO_TRACE_CLOCK(), std::memory_order_relaxed);
+        s.kind_arg.store(static_cast<std::uint32_t>(kind) | (static_cast<std::uint32_t>(arg) << 16),
+                         std::memory_order_relaxed);
+        s.task.store(reinterpret_cast<std::uintptr_t>(task), std::memory_order_relaxed);
+        s.seq.store(n + 1, std::memory_order_release);
+    }
+
+    // copy up to max newest complete records, oldest first; returns how many
+    std::size_t snapshot(TraceRecord* out, std::size_t max) const noexcept {
+        const std::uint32_t end = head.load(std::memory_order_acquire);
+        std::uint32_t begin = end > Capacity ? end - static_cast<std::uint32_t>(Capacity) : 0;
+        if (end - begin > max) {
+            begin = end - static_cast<std::uint32_t>(max);
+        }
+
+        std::size_t count = 0;
+        for (std::uint32_t n = begin; n != end; ++n) {
+            const Slot& s = slots[n & mask];
+            if (s.seq.load(std::memory_order_acquire) != n + 1) {
+                continue;   // overwritten or still being written
+            }
+            TraceRecord r{};
+            r.time = s.time.load(std::memory_order_relaxed);
+            const std::uint32_t ka = s.kind_arg.load(std::memory_order_relaxed);
+            r.task = s.task.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);    // pairs with the release fence in record()
+            if (s.seq.load(std::memory_order_relaxed) != n + 1) {
+                continue;
+            }
+            r.seq = n;
+            r.kind = static_cast<TraceKind>(ka & 0xFFFFu);
+            r.arg = static_cast<std::uint16_t>(ka >> 16);
+            out[count++] = r;
+        }
+        return count;
+    }
+
+    /*
+     * binary dump for tools/ucoro_trace2chrome.py:
+     *  header  : "UCTR", u32 version (1), u32 record count      (little endian)
+     *  record  : u32 seq, u32 time, u16 kind, u16 arg, u64 task  (20 bytes)
+     */
+    bool dump(std::FILE* out) const {
+        static TraceRecord records[Capacity];   // not on the stack: Capacity may be large
+        const std::size_t count = snapshot(records, Capacity);
+
+        unsigned char header[12] = {'U', 'C', 'T', 'R'};
+        put_le(header + 4, 1u, 4);
+        put_le(header + 8, count, 4);
+        if (std::fwrite(header, sizeof(header), 1, out) != 1) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const TraceRecord& r = records[i];
+            unsigned char buf[20];
+            put_le(buf + 0, r.seq, 4);
+            put_le(buf + 4, r.time, 4);
+            put_le(buf + 8, static_cast<std::uint16_t>(r.kind), 2);
+            put_le(buf + 10, r.arg, 2);
+            put_le(buf + 12, r.task, 8);
+            if (std::fwrite(buf, sizeof(buf), 1, out) != 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void clear() noexcept {
+        for (auto& s : slots) {
+            s.seq.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static constexpr std::uint32_t mask = static_cast<std::uint32_t>(Capacity) - 1;
+
+    struct Slot {
+        std::atomic<std::uint32_t> seq{0};
+        std::atomic<std::uint32_t> time{0};
+        std::atomic<std::uint32_t> kind_arg{0};
+        std::atomic<std::uintptr_t> task{0};
+    };
+
+    static void put_le(unsigned char* p, std::uint64_t v, std::size_t bytes) noexcept {
+        for (std::size_t i = 0; i < bytes; ++i) {
+            p[i] = static_cast<unsigned char>(v >> (8 * i));
+        }
+    }
+
+    std::atomic<std::uint32_t> head{0};
+    Slot slots[Capacity];
+};
+
+#if UCORO_TRACE
+inline TraceBuffer<UCORO_TRACE_CAPACITY> trace_buffer;
+#endif
+
+} /* namespace ucoro */
+
+#if UCORO_TRACE
+#   define UCORO_TRACE_RECORD(kind, task, arg) \
+        ::ucoro::trace_buffer.record(::ucoro::TraceKind::kind, (task), static_cast<std::uint16_t>(arg))
+#else
+#   define UCORO_TRACE_RECORD(kind, task, arg) ((void)0)
+#endif
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_TRACE_H
@@ -0,0 +1,285 @@
+#ifndef CORO_WHEN_H
+#define CORO_WHEN_H
+
+#include "coro_policy.h"
+
+#if UCORO_ENABLED /* **********************UCORO_ENABLED*************************** */
+
+#include "u_coro.h"
+#include <array>
+#include <exception>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace ucoro {
+
+// result slot of a Task<void>
+struct VoidResult { };
+
+template<class T>
+using when_result_t = std::conditional_t<std::is_void_v<T>, VoidResult, T>;
+
+namespace detail {
+
+// hand a child over to the scheduler of the awaiting task (the caller checked it has one);
+// the child inherits the parent's scheduling key (priority, deadline)
+template<class Policy, class Promise>
+void start_child(const ReadyLink<Policy>& parent, std::coroutine_handle<Promise> child) noexcept {
+    ReadyLink<Policy>& link = child.promise();
+    if (link.sink != nullptr) {
+        return;                         // already attached somewhere
+    }
+    ReadySink<Policy>* sink = parent.sink;
+    link.handle = child;
+    link.sched_key = parent.sched_key;
+    link.sched_flags = parent.sched_flags;
+    sink->attach(*sink, link);
+}
+
+// when_all / when_any awaited by a task that is not attached to a scheduler
+[[noreturn]] inline void no_scheduler() {
+#if defined(__cpp_exceptions)
+    throw std::logic_error("[UCORO]: when_all() / when_any() need a task attached to a scheduler");
+#else
+    std::terminate();
+#endif
+}
+
+template<class Task>
+void rethrow_if_error(const Task& task) {
+#if defined(__cpp_exceptions)
+    if constexpr (std::is_same_v<typename Task::promise_type::error_t, std::exception_ptr>) {
+        if (task.has_error()) {
+            std::rethrow_exception(task.get_error());
+        }
+    }
+#else
+    (void)task;
+#endif
+}
+
+} /* namespace detail */
+
+/*
+ * *******************************************************************
+ *  WhenAll:
+ *  awaits every child task; the parent stays blocked (costs nothing
+ *  in the scheduler) and is woken once, by the last child to finish.
+ *  Children are owned by the awaitable (in the parent frame) and run
+ *  on the parent's scheduler. Result: tuple of the child values,
+ *  VoidResult for Task<void>.
+ *  The awaiting task must be attached to a scheduler (children are
+ *  never run in place): otherwise co_await throws std::logic_error
+ *  (std::terminate() without exceptions) and no child is started.
+ *
+ *  auto [a, b, _] = co_await ucoro::when_all(read_adc(), read_temp(), blink());
+ * *******************************************************************
+*/
+template<class Policy, class... Ts>
+class WhenAll {
+    static_assert(use_scheduler_v<Policy> && use_await_v<Policy> && !Policy::is_atomic,
+                  "[UCORO]: when_all() needs a blocking single-context policy (Plain / Volatile), not Lean");
+
+public:
+    explicit WhenAll(Task<Ts, Policy>&&... children) noexcept : tasks(std::move(children)...) {}
+    WhenAll(const WhenAll&) = delete;
+    WhenAll& operator=(const WhenAll&) = delete;
+
+    bool await_ready() const noexcept {
+        return std::apply([](const auto&... t) { return (t.done() && ...); }, tasks);
+    }
+
+    template<class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        static_assert(std::is_same_v<typename Promise::policy_t, Policy>,
+                      "[UCORO]: when_all() children must use the parent's policy");
+
+        auto& promise = h.promise();
+        promise.block();
+        parent = Waker::of(promise);
+        remaining = 1;      // held by us until every child is started
+
+        const ReadyLink<Policy>& root = *promise.root;
+        if (root.sink == nullptr) {
+            unscheduled = true;
+            promise.unblock();
+            return false;
+        }
+        std::apply([&](auto&... t) { (start(root, t), ...); }, tasks);
+
+        if (--remaining == 0) {
+            promise.unblock();
+            return false;
+        }
+        return true;
+    }
+
+    std::tuple<when_result_t<Ts>...> await_resume() {
+        if (unscheduled) {
+            detail::no_scheduler();
+        }
+        std::apply([](const auto&... t) { (detail::rethrow_if_error(t), ...); }, tasks);
+        return std::apply([](auto&... t) { return std::tuple<when_result_t<Ts>...>{result(t)...}; }, tasks);
+    }
+
+private:
+    template<class Task>
+    void start(const ReadyLink<Policy>& root, Task& task) noexcept {
+        if (task.done()) {
+            return;
+        }
+        ++remaining;
+        auto& core = static_cast<PromiseCore<Policy>&>(task.handle().promise());
+        core.on_finish = Waker{&WhenAll::on_child_done, this};
+        detail::start_child(root, task.handle());
+    }
+
+    static void on_child_done(void* self) noexcept {
+        auto& w = *static_cast<WhenAll*>(self);
+        if (--w.remaining == 0) {
+            w.parent();
+        }
+    }
+
+    template<class T>
+    static when_result_t<T> result(Task<T, Policy>& task) noexcept {
+        if constexpr (std::is_void_v<T>) {
+            return {};
+        } else {
+            return task.is_valid() ? task.value() : T{};
+        }
+    }
+
+    std::tuple<Task<Ts, Policy>...> tasks;
+    Waker parent{};
+    std::size_t remaining = 0;
+    bool unscheduled = false;
+};
+
+/*
+ * *******************************************************************
+ *  WhenAny:
+ *  awaits the first child to finish and returns its index. The parent
+ *  is woken once, by the winner; the other children are destroyed
+ *  (and so dropped from the scheduler) before co_await returns.
+ *  Like when_all(), needs a parent attached to a scheduler.
+ *
+ *  switch (co_await ucoro::when_any(wait_ack(), ucoro_timeout(100))) { ... }
+ * *******************************************************************
+*/
+template<class Policy, class... Ts>
+class WhenAny {
+    static_assert(use_scheduler_v<Policy> && use_await_v<Policy> && !Policy::is_atomic,
+                  "[UCORO]: when_any() needs a blocking single-context policy (Plain / Volatile), not Lean");
+
+public:
+    static constexpr std::size_t none = sizeof...(Ts);
+
+    explicit WhenAny(Task<Ts, Policy>&&... children) noexcept : tasks(std::move(children)...) {}
+    WhenAny(const WhenAny&) = delete;
+    WhenAny& operator=(const WhenAny&) = delete;
+
+    bool await_ready() noexcept {
+        find_done(std::index_sequence_for<Ts...>{});
+        return winner != none;
+    }
+
+    template<class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        static_assert(std::is_same_v<typename Promise::policy_t, Policy>,
+                      "[UCORO]: when_any() children must use the parent's policy");
+
+        auto& promise = h.promise();
+        promise.block();
+        parent = Waker::of(promise);
+
+        if (promise.root->sink == nullptr) {
+            unscheduled = true;
+            promise.unblock();
+            return false;
+        }
+        start_all(*promise.root, std::index_sequence_for<Ts...>{});
+
+        if (winner != none) {
+            promise.unblock();
+            return false;
+        }
+        return true;
+    }
+
+    // index of the first child that finished
+    std::size_t await_resume() {
+        if (unscheduled) {
+            detail::no_scheduler();
+        }
+        cancel_losers(std::index_sequence_for<Ts...>{});
+        rethrow_winner(std::index_sequence_for<Ts...>{});
+        return winner;
+    }
+
+private:
+    struct Slot {
+        WhenAny* self;
+        std::size_t index;
+    };
+
+    template<std::size_t... I>
+    void find_done(std::index_sequence<I...>) noexcept {
+        ((winner == none && std::get<I>(tasks).done() ? (void)(winner = I) : void()), ...);
+    }
+
+    template<std::size_t... I>
+    void start_all(const ReadyLink<Policy>& root, std::index_sequence<I...>) noexcept {
+        ((winner == none ? start<I>(root) : void()), ...);
+    }
+
+    template<std::size_t I>
+    void start(const ReadyLink<Policy>& root) noexcept {
+        auto& task = std::get<I>(tasks);
+        slots[I] = Slot{this, I};
+        auto& core = static_cast<PromiseCore<Policy>&>(task.handle().promise());
+        core.on_finish = Waker{&WhenAny::on_child_done, &slots[I]};
+        detail::start_child(root, task.handle());
+    }
+
+    static void on_child_done(void* slot) noexcept {
+        const Slot& s = *static_cast<Slot*>(slot);
+        if (s.self->winner == none) {
+            s.self->winner = s.index;
+            s.self->parent();
+        }
+    }
+
+    template<std::size_t... I>
+    void cancel_losers(std::index_sequence<I...>) noexcept {
+        ((I != winner ? (void)(std::get<I>(tasks) = Task<Ts, Policy>{}) : void()), ...);
+    }
+
+    template<std::size_t... I>
+    void rethrow_winner(std::index_sequence<I...>) {
+        ((I == winner ? detail::rethrow_if_error(std::get<I>(tasks)) : void()), ...);
+    }
+
+    std::tuple<Task<Ts, Policy>...> tasks;
+    std::array<Slot, sizeof...(Ts)> slots{};
+    Waker parent{};
+    std::size_t winner = none;
+    bool unscheduled = false;
+};
+
+template<class Policy, class... Ts>
+WhenAll<Policy, Ts...> when_all(Task<Ts, Policy>&&... tasks) noexcept {
+    return WhenAll<Policy, Ts...>{std::move(tasks)...};
+}
+
+template<class Policy, class... Ts>
+WhenAny<Policy, Ts...> when_any(Task<Ts, Policy>&&... tasks) noexcept {
+    static_assert(sizeof...(Ts) > 0, "[UCORO]: when_any() needs at least one task");
+    return WhenAny<Policy, Ts...>{std::move(tasks)...};
+}
+
+} /* namespace ucoro */
+
+#endif /* **********************UCORO_ENABLED*************************** */
+#endif // CORO_WHEN_H
@@ -46,6 +46,9 @@ struct Promise : PromiseBase<TaskT, Policy> {
 
     T val{};
 
+    T result() const noexcept { return val; }
+    static T empty_result() noexcept { return T{}; }
+
     void return_value(T v) noexcept { val = std::move(v); }
     auto yield_value(T v) noexcept {
         val = std::move(v);
@@ -57,6 +60,9 @@ struct Promise : PromiseBase<TaskT, Policy> {
 // Specialization for void
 template<class TaskT, class Policy>
 struct Promise<void, TaskT, Policy> : PromiseBase<TaskT, Policy> {
+    constexpr void result() const noexcept {}
+    static constexpr void empty_result() noexcept {}
+
     constexpr void return_void() noexcept {}
     constexpr std::suspend_always yield_value(std::suspend_always) noexcept { return {}; }
 };
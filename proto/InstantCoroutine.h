@@ -212,6 +212,8 @@ SOFTWARE.
 #ifndef InstantCoroutine_INCLUDED_H
 #define InstantCoroutine_INCLUDED_H
 
+#include <stddef.h>
+
 //______________________________________________________________________________
 // Configurable error handling and interrupt safety
 
@@ -317,9 +319,147 @@ class CoroutineBase;
         } \
     private:
 
+//______________________________________________________________________________
+// Batched coroutines (many values per call)
+
+/// Generator body follows, filling many values per call (instead of CoroutineBegin)
+/** Defines Pull(out, count): resumes the coroutine until count values were
+ * yielded (or it stopped) and stores them to out, returns how many were stored;
+ * the switch is entered once per Pull, not once per value.
+ * operator()() still yields a single value (coroutineResultType shall be
+ * default constructible for that).
+ * Use CoroutinePullYield(value) / CoroutinePullStop() inside
+ * (plain CoroutineYield/CoroutineStop do not compile there),
+ * end with CoroutineEnd() as usual.
+ @code
+    CoroutineDefine( Squares ) {
+        int i = 0;
+        CoroutinePullBegin(int)
+            for ( ;; ++i){
+                CoroutinePullYield( i*i );
+            }
+        CoroutineEnd()
+    } squares;
+
+    int buffer[64];
+    size_t n = squares.Pull(buffer, 64); // 64 values in one call
+ @endcode */
+#define CoroutinePullBegin(coroutineResultType) \
+    public: \
+        typedef coroutineResultType CppCoroutine_Pull_t; \
+        /* Fill out with up to count values, returns how many were stored */ \
+        size_t Pull(CppCoroutine_Pull_t* out, size_t count) { \
+            return count ? CppCoroutine_Pull(out, count).count : 0; \
+        } \
+        /* Single value (default one if the coroutine stopped without it) */ \
+        CppCoroutine_Pull_t operator()() { \
+            CppCoroutine_Pull_t cppCoroutine_Value{}; \
+            CppCoroutine_Pull(&cppCoroutine_Value, 1); \
+            return cppCoroutine_Value; \
+        } \
+    private: \
+        CppCoroutine_BatchCount CppCoroutine_Pull( \
+            CppCoroutine_Pull_t* cppCoroutine_Out, size_t cppCoroutine_Capacity \
+        ) { \
+            size_t cppCoroutine_Done = 0; \
+            static constexpr CppCoroutine_State::Holder \
+                CppCoroutineState_COUNTER_START = COROUTINE_PLACE_COUNTER; \
+            switch( cppCoroutine_State.current ){ \
+                case CppCoroutine_State::Initial:;
+
+/// Store value for Pull(), suspends only once the caller's buffer is full
+#define CoroutinePullYield(...) \
+    COROUTINE_PULL_YIELD_FROM(\
+        (CppCoroutine_State::Initial + (COROUTINE_PLACE_COUNTER - CppCoroutineState_COUNTER_START)), \
+        __VA_ARGS__ )
+
+/// The "the last return" from a CoroutinePullBegin() coroutine
+/** Values yielded before are kept, Pull() returns their number */
+#define CoroutinePullStop() \
+    do { \
+        cppCoroutine_State.current = CppCoroutine_State::Final; \
+        return CppCoroutine_BatchCount(cppCoroutine_Done); \
+    } while (false)
+
+/// Consumer body follows, taking many parameters per call (instead of CoroutineBegin)
+/** Defines Push(in, count): resumes the coroutine once per element of in,
+ * as operator()(parameterName) would, until all count elements were consumed
+ * or it stopped; returns how many were consumed (the one it stopped on included).
+ * The switch is entered once per Push, not once per element.
+ * operator()(parameterName) still takes a single element.
+ * Use CoroutinePushYield() / CoroutinePushYieldUntil() / CoroutinePushStop()
+ * inside (plain CoroutineYield/CoroutineStop do not compile there),
+ * end with CoroutineEnd() as usual.
+ @code
+    CoroutineDefine( Decompressor ) {
+        unsigned len = 0;
+        CoroutinePushBegin(int, c)
+            for (;;) {
+                if (c == 0xFF) {
+                    CoroutinePushYield(); // next element is the length
+                    len = c;
+                    CoroutinePushYield(); // then the repeated char
+                    while (len--){
+                        parser(c);
+                    }
+                }
+                else{
+                    parser(c);
+                }
+                CoroutinePushYield();
+            }
+        CoroutineEnd()
+    } decompressor;
+
+    decompressor.Push(received, receivedCount);
+ @endcode */
+#define CoroutinePushBegin(parameterType, parameterName) \
+    public: \
+        typedef parameterType CppCoroutine_Push_t; \
+        /* Consume up to count elements, returns how many were consumed */ \
+        size_t Push(const CppCoroutine_Push_t* in, size_t count) { \
+            return count ? CppCoroutine_Push(in, count).count : 0; \
+        } \
+        /* Single element */ \
+        void operator()(CppCoroutine_Push_t parameterName) { \
+            CppCoroutine_Push(&parameterName, 1); \
+        } \
+    private: \
+        CppCoroutine_BatchCount CppCoroutine_Push( \
+            const CppCoroutine_Push_t* cppCoroutine_In, size_t cppCoroutine_Capacity \
+        ) { \
+            size_t cppCoroutine_Done = 0; \
+            CppCoroutine_Push_t parameterName = cppCoroutine_In[0]; \
+            CppCoroutine_Push_t* const cppCoroutine_Parameter = &parameterName; \
+            static constexpr CppCoroutine_State::Holder \
+                CppCoroutineState_COUNTER_START = COROUTINE_PLACE_COUNTER; \
+            switch( cppCoroutine_State.current ){ \
+                case CppCoroutine_State::Initial:;
+
+/// Wait for the next element, suspends only once Push() input is consumed
+#define CoroutinePushYield() \
+    COROUTINE_PUSH_YIELD_FROM(\
+        (CppCoroutine_State::Initial + (COROUTINE_PLACE_COUNTER - CppCoroutineState_COUNTER_START)) )
+
+#define CoroutinePushYieldUntil(condition) do{ CoroutinePushYield(); } while(!(condition))
+
+/// The "the last return" from a CoroutinePushBegin() coroutine
+#define CoroutinePushStop() \
+    do { \
+        cppCoroutine_State.current = CppCoroutine_State::Final; \
+        return CppCoroutine_BatchCount(cppCoroutine_Done + 1); \
+    } while (false)
+
 //______________________________________________________________________________
 // (needs to be declared in advance, just skip this section))
 
+///Result of the batched coroutine body (not constructible from yielded values,
+///so plain CoroutineYield/CoroutineStop fail to compile inside of it)
+struct CppCoroutine_BatchCount{
+    explicit CppCoroutine_BatchCount(size_t n) : count(n) {}
+    size_t count;
+};
+
 struct CppCoroutine_State{
     ///Type for coroutine state
     /** Assume our __LINE__ will never go beyond */
@@ -412,6 +552,29 @@ protected:
     return __VA_ARGS__; \
     case cppCoroutine_place_id:;
 
+///Helper macro for CoroutinePullYield: store, suspend only when out is full
+#define COROUTINE_PULL_YIELD_FROM(cppCoroutine_place_id, /*yielded value*/ ...) \
+    do{ \
+        cppCoroutine_Out[cppCoroutine_Done++] = (__VA_ARGS__); \
+        if( cppCoroutine_Done == cppCoroutine_Capacity ){ \
+            COROUTINE_REMEMBER_STATE(cppCoroutine_place_id) \
+            COROUTINE_INTERNAL_SUSPEND(cppCoroutine_place_id, CppCoroutine_BatchCount(cppCoroutine_Done)) \
+        } \
+    } while (false)
+
+///Helper macro for CoroutinePushYield: next element, suspend only when in is consumed
+/** Resuming lands inside the if (parameter already holds in[0]) */
+#define COROUTINE_PUSH_YIELD_FROM(cppCoroutine_place_id) \
+    do{ \
+        if( ++cppCoroutine_Done == cppCoroutine_Capacity ){ \
+            COROUTINE_REMEMBER_STATE(cppCoroutine_place_id) \
+            COROUTINE_INTERNAL_SUSPEND(cppCoroutine_place_id, CppCoroutine_BatchCount(cppCoroutine_Done)) \
+        } \
+        else{ \
+            *cppCoroutine_Parameter = cppCoroutine_In[cppCoroutine_Done]; \
+        } \
+    } while (false)
+
 
 //define macro to obtain sequential numbers (optimizes switch statement a lot!)
 #if defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__) || defined(__IAR_SYSTEMS_ICC__)
@@ -0,0 +1,210 @@
+/** @file InstantCoroutineBulk.h
+ @brief Many instances of one InstantCoroutine, stored as arrays and stepped in one pass
+
+For the case of thousands of identical coroutines (one per sensor, per connection...).
+A regular CoroutineDefine() object mixes its state with its fields, and an array of
+such objects is walked object by object, finished ones included.
+CoroutineBulk keeps instead
+ - all the states in one dense array (2 bytes per instance),
+ - all the fields in a separate array of a user "Fields" struct,
+ - a packed bitmap of instances that did not finish yet,
+so RunAll() visits only unfinished instances (whole words of finished ones are
+skipped at once) and touches only their state and fields.
+
+The coroutine body is written with the usual macros, but the class is only a
+short-lived view bound to one slot: fields live in the Fields struct and are
+accessed through "fields." (do not declare data members in the class itself!).
+
+Example Usage:
+ @code
+
+    #include "InstantCoroutineBulk.h"
+
+    struct SensorFields {
+        int value = 0;
+        unsigned samples = 0;
+    };
+
+    CoroutineBulkDefine( SensorPoll, SensorFields ) {
+        CoroutineBulkBegin(void, int raw)
+            for (;;) {
+                fields.value = raw;
+                if (++fields.samples == 100) {
+                    CoroutineStop();
+                }
+                CoroutineYield();
+            }
+        CoroutineEnd()
+    };
+
+    CoroutineBulk<SensorPoll, 10000> sensors;
+
+    void loop() {
+        // resume every unfinished instance once (all get the same parameters)
+        if( !sensors.RunAll(readAdc()) ){
+            // all finished
+        }
+        sensors[42].value;     // fields of the instance #42
+        sensors.At(7)(0);      // resume only instance #7
+    }
+ @endcode
+
+NOTE: fields are not reset by Restart(i), assign them via operator[] if needed.
+NOTE: not threadsafe/interrupt safe, same as InstantCoroutine.h
+
+MIT License (same as InstantCoroutine.h)
+*/
+
+#ifndef InstantCoroutineBulk_INCLUDED_H
+#define InstantCoroutineBulk_INCLUDED_H
+
+#include "InstantCoroutine.h"
+#include <stddef.h>
+
+//______________________________________________________________________________
+// Bulk coroutine public API
+
+/// Define view class for coroutine with fields kept in fieldsType
+/** Class body shall follow in {}, with CoroutineBulkBegin(...) / CoroutineEnd()
+ * inside; fields are reached by "fields." from the coroutine body.
+ * REMEMBER: no data members in the class, it lives only for one resume! */
+#define CoroutineBulkDefine(coroutineClassName, fieldsType) \
+    class coroutineClassName: public CoroutineBulkView<fieldsType>
+
+/// Same as CoroutineBegin(), for classes from CoroutineBulkDefine()
+#define CoroutineBulkBegin(coroutineResultType, ...) \
+    public: \
+        using CoroutineBulkViewBase::CoroutineBulkViewBase; \
+    CoroutineBegin(coroutineResultType, __VA_ARGS__)
+
+
+///Base of all bulk coroutine views: one slot (state + fields) of CoroutineBulk
+template<class Fields>
+class CoroutineBulkView{
+public:
+    typedef Fields BulkFields;
+
+    ///Bind to the state and fields of one instance
+    CoroutineBulkView(CppCoroutine_State& state, Fields& instanceFields)
+        : cppCoroutine_State(state), fields(instanceFields) {}
+
+    ///Test coroutine did not finish (CoroutineStop was NOT called)
+    operator bool() const {
+        return !Finished();
+    }
+
+    ///Test coroutine finished (CoroutineStop was called)
+    bool Finished() const {
+        return CppCoroutine_State::Final == cppCoroutine_State.current;
+    }
+
+protected:
+    ///For using inherited constructor from CoroutineBulkBegin()
+    typedef CoroutineBulkView CoroutineBulkViewBase;
+
+    /// Actual coroutine state (inside of CoroutineBulk)
+    CppCoroutine_State& cppCoroutine_State;
+    /// Fields of this instance (inside of CoroutineBulk)
+    Fields& fields;
+};
+
+
+///Count instances of Coroutine (from CoroutineBulkDefine) in arrays
+/** Instances start suspended at the beginning, with default constructed fields */
+template<class Coroutine, size_t Count>
+class CoroutineBulk{
+public:
+    typedef typename Coroutine::BulkFields Fields;
+
+    static_assert(Count > 0, "Empty CoroutineBulk");
+    static_assert(sizeof(Coroutine) == sizeof(CoroutineBulkView<Fields>),
+                  "Bulk coroutine shall not have data members, place them to Fields");
+
+    static constexpr size_t Size = Count;
+
+    CoroutineBulk(){
+        for(size_t w = 0; w < WordCount; ++w){
+            running[w] = ~Word(0);
+        }
+        if( Count % BitsPerWord ){
+            running[WordCount - 1] = (Word(1) << (Count % BitsPerWord)) - 1;
+        }
+        runningCount = Count;
+    }
+
+    ///Fields of the instance i
+    Fields& operator[](size_t i) { return fields[i]; }
+    const Fields& operator[](size_t i) const { return fields[i]; }
+
+    ///View of the instance i, call it to resume only that instance
+    Coroutine At(size_t i) { return Coroutine(states[i], fields[i]); }
+
+    ///Test instance i finished (CoroutineStop was called)
+    bool Finished(size_t i) const {
+        return CppCoroutine_State::Final == states[i].current;
+    }
+
+    ///Number of instances that did not finish (as of the last RunAll)
+    size_t Running() const { return runningCount; }
+
+    ///Start instance i from the beginning again (fields are kept)
+    void Restart(size_t i){
+        Word& word = running[i / BitsPerWord];
+        const Word bit = Word(1) << (i % BitsPerWord);
+        if( !(word & bit) ){
+            word |= bit;
+            ++runningCount;
+        }
+        states[i].current = CppCoroutine_State::Initial;
+    }
+
+    ///Resume every unfinished instance once, in index order
+    /** All instances get the same resume parameters (if any),
+     *  returns number of instances that did not finish yet */
+    template<class... Args>
+    size_t RunAll(const Args&... args){
+        for(size_t w = 0; w < WordCount; ++w){
+            Word pending = running[w];
+            while( pending ){
+                const unsigned b = LowestBit(pending);
+                pending &= pending - 1;
+
+                const size_t i = w * BitsPerWord + b;
+                // also catches an instance finished via At(i)
+                if( !Finished(i) ){
+                    Coroutine(states[i], fields[i])(args...);
+                }
+                if( Finished(i) ){
+                    running[w] &= ~(Word(1) << b);
+                    --runningCount;
+                }
+            }
+        }
+        return runningCount;
+    }
+
+private:
+    typedef unsigned long Word;
+    static constexpr size_t BitsPerWord = sizeof(Word) * 8;
+    static constexpr size_t WordCount = (Count + BitsPerWord - 1) / BitsPerWord;
+
+    static unsigned LowestBit(Word w){
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzl(w));
+#else
+        unsigned n = 0;
+        while( !(w & 1) ){
+            w >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    CppCoroutine_State states[Count];
+    Word running[WordCount];
+    size_t runningCount;
+    Fields fields[Count];
+};
+
+#endif
@@ -8,7 +8,12 @@
 // it for more information:
 //     http://blog.brush.co.nz/2008/07/protothreads/
 //
-// Visual Studio users: There's a quirk with VS where it defines __LINE__
+// Wait points are numbered densely (1, 2, 3... per Run()) from __COUNTER__,
+// so the switch in PT_BEGIN compiles to a jump table and the state fits in
+// PT_STATE_TYPE (one byte by default, see below).
+//
+// Visual Studio users (only on compilers without __COUNTER__, where __LINE__
+// is used instead): There's a quirk with VS where it defines __LINE__
 // as a non-constant when you've got a project's Debug Information Format
 // set to "Program Database for Edit and Continue (/ZI)" -- the default.
 // To fix, just go to the project's Properties, Configuration Properties,
@@ -23,6 +28,18 @@
 #ifndef __PROTOTHREAD_H__
 #define __PROTOTHREAD_H__
 
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+// Type of the protothread's position, i.e. the number of its current wait
+// point. The default allows 254 wait points per Run(); more fail to compile
+// (static_assert). Define before including this header to change the
+// default, or pass it to StaticProtothread per class.
+#ifndef PT_STATE_TYPE
+#define PT_STATE_TYPE unsigned char
+#endif
+
 // A lightweight, stackless thread. Override the Run() method and use
 // the PT_* macros to do work of the thread.
 //
@@ -56,16 +73,15 @@
 //     PT_END();
 // }
 //
-class Protothread
+// State shared by Protothread and StaticProtothread: the position and the
+// Restart()/Stop()/IsRunning() used by the PT_* macros.
+template <class State = PT_STATE_TYPE>
+class ProtothreadBase
 {
-public:
-    // Construct a new protothread that will start from the beginning
-    // of its Run() function.
-    Protothread() : _ptLine(0) { }
-
-    // Virtual destructor in case subclass wants to delete via base pointer.
-    virtual ~Protothread() = default;
+    static_assert(std::is_integral<State>::value && std::is_unsigned<State>::value,
+                  "ProtothreadBase: State must be an unsigned integer type");
 
+public:
     // Restart protothread.
     inline void Restart() { _ptLine = 0; }
 
@@ -78,30 +94,169 @@ public:
     // ended or exited.
     inline bool IsRunning() const { return _ptLine != LineNumberInvalid; }
 
-    // Run next part of protothread or return immediately if it's still
-    // waiting. Return true if protothread is still running, false if it
-    // has finished. Implement this method in your Protothread subclass.
-    virtual bool Run() = 0;
+    // Return the wait point the protothread is at, for diagnostics: 0 before
+    // the first Run() (or after Restart()), then 1, 2, ... for the PT_WAIT_*
+    // and PT_YIELD* macros in the order they appear in Run() (other users of
+    // __COUNTER__ inside Run() leave gaps). LineNumberInvalid once ended.
+    inline unsigned long WaitPoint() const { return _ptLine; }
 
 protected:
+    // Construct a new protothread that will start from the beginning
+    // of its Run() function.
+    ProtothreadBase() : _ptLine(0) { }
+
+    // Not deleted via this base (no virtual destructor here).
+    ~ProtothreadBase() = default;
+
     // Used to store a protothread's position (what Dunkels calls a
     // "local continuation").
-    typedef unsigned int LineNumber;
+    typedef State LineNumber;
 
     // An invalid line number, used to mark the protothread has ended.
     static constexpr LineNumber LineNumberInvalid = static_cast<LineNumber>(-1);
 
-    // Stores the protothread's position (by storing the line number of
-    // the last PT_WAIT, which is then switched on at the next Run).
-    LineNumber _ptLine = 0;
+    // Stores the protothread's position (by storing the number of the
+    // last PT_WAIT, which is then switched on at the next Run).
+    LineNumber _ptLine;
+};
+
+class Protothread : public ProtothreadBase<>
+{
+public:
+    Protothread() = default;
+
+    // Virtual destructor in case subclass wants to delete via base pointer.
+    virtual ~Protothread() = default;
+
+    // Run next part of protothread or return immediately if it's still
+    // waiting. Return true if protothread is still running, false if it
+    // has finished. Implement this method in your Protothread subclass.
+    virtual bool Run() = 0;
+};
+
+// Protothread without the vtable: the derived class passes itself as the
+// template argument and defines a plain (non-virtual) Run() with the same
+// PT_* macros. Calls are resolved at compile time and can be inlined, and
+// the object is one LineNumber big (State, PT_STATE_TYPE by default). Use ProtothreadScheduler (below) to
+// run a fixed set of them.
+//
+// class LEDFlasher : public StaticProtothread<LEDFlasher>
+// {
+// public:
+//     bool Run();
+//     ...
+// };
+//
+template <class Derived, class State = PT_STATE_TYPE>
+class StaticProtothread : public ProtothreadBase<State>
+{
+public:
+    // Run Derived::Run() (same meaning as Protothread::Run()), for code
+    // that only knows the StaticProtothread<Derived> base.
+    inline bool Run()
+    {
+        static_assert(std::is_same<decltype(&Derived::Run), bool (Derived::*)()>::value,
+                      "StaticProtothread: Derived must define bool Run()");
+        return static_cast<Derived*>(this)->Run();
+    }
+
+protected:
+    StaticProtothread() = default;
+    ~StaticProtothread() = default;
+};
+
+// Runs a fixed, heterogeneous set of protothreads kept in a std::tuple.
+// The element types are known at compile time, so RunOnce() is an unrolled
+// sequence of direct (inlinable) Run() calls; threads that have ended are
+// skipped without calling them. Elements can be StaticProtothread or
+// Protothread subclasses (ideally final) held by value, or references
+// (see MakeProtothreadScheduler).
+//
+// ProtothreadScheduler<LEDFlasher, UartReader> threads;
+// while (threads.RunOnce() != 0)
+// {
+//     ...
+// }
+//
+template <class... Threads>
+class ProtothreadScheduler
+{
+    static_assert(sizeof...(Threads) > 0, "ProtothreadScheduler: no threads");
+
+public:
+    static constexpr std::size_t Size = sizeof...(Threads);
+
+    ProtothreadScheduler() = default;
+    explicit ProtothreadScheduler(Threads... threads) : _threads(threads...) { }
+
+    // Run every running thread once, in order. Return how many are still
+    // running afterwards.
+    inline std::size_t RunOnce() { return RunFrom<0>(More<0>()); }
+
+    // Return true if any thread is still running.
+    inline bool IsRunning() const { return RunningFrom<0>(More<0>()); }
+
+    // Restart every thread.
+    inline void Restart() { RestartFrom<0>(More<0>()); }
+
+    template <std::size_t I>
+    inline typename std::tuple_element<I, std::tuple<Threads...> >::type& Get()
+    {
+        return std::get<I>(_threads);
+    }
+
+private:
+    template <std::size_t I>
+    using More = std::integral_constant<bool, (I < sizeof...(Threads))>;
+
+    template <std::size_t I>
+    inline std::size_t RunFrom(std::true_type)
+    {
+        auto& thread = std::get<I>(_threads);
+        const std::size_t running = (thread.IsRunning() && thread.Run()) ? 1 : 0;
+        return running + RunFrom<I + 1>(More<I + 1>());
+    }
+
+    template <std::size_t I>
+    inline std::size_t RunFrom(std::false_type) { return 0; }
+
+    template <std::size_t I>
+    inline bool RunningFrom(std::true_type) const
+    {
+        return std::get<I>(_threads).IsRunning() || RunningFrom<I + 1>(More<I + 1>());
+    }
+
+    template <std::size_t I>
+    inline bool RunningFrom(std::false_type) const { return false; }
+
+    template <std::size_t I>
+    inline void RestartFrom(std::true_type)
+    {
+        std::get<I>(_threads).Restart();
+        RestartFrom<I + 1>(More<I + 1>());
+    }
+
+    template <std::size_t I>
+    inline void RestartFrom(std::false_type) { }
+
+    std::tuple<Threads...> _threads;
 };
 
+// Scheduler over existing protothreads (held by reference).
+template <class... Threads>
+inline ProtothreadScheduler<Threads&...> MakeProtothreadScheduler(Threads&... threads)
+{
+    return ProtothreadScheduler<Threads&...>(threads...);
+}
+
 // Declare start of protothread (use at start of Run() implementation).
 #define PT_BEGIN()                                                          \
     bool ptYielded = true;                                                  \
     (void)ptYielded;                                                        \
+    static constexpr unsigned long ptStateStart = PT_PLACE_COUNTER;         \
+    (void)ptStateStart;                                                     \
                                                                             \
-    switch (_ptLine) {                                                      \
+    switch (this->_ptLine) {                                                \
         /* fall through */                                                  \
         case 0:
 
@@ -110,19 +265,11 @@ protected:
         /* fall through */                                                  \
         default: ;                                                          \
     }                                                                       \
-    Stop();                                                                 \
+    this->Stop();                                                           \
     return false;
 
 // Cause protothread to wait until given condition is true.
-#define PT_WAIT_UNTIL(condition)                                            \
-    do {                                                                    \
-            _ptLine = __LINE__;                                             \
-        /* fall through */                                                  \
-        case __LINE__:                                                      \
-            if (!(condition)) {                                             \
-                return true; /* still running */                            \
-            }                                                               \
-    } while (0)
+#define PT_WAIT_UNTIL(condition) PT_WAIT_UNTIL_AT(PT_NEXT_STATE(), condition)
 
 // Cause protothread to wait while given condition is true.
 #define PT_WAIT_WHILE(condition) PT_WAIT_UNTIL(!(condition))
@@ -141,38 +288,60 @@ protected:
 // Restart protothread's execution at its PT_BEGIN.
 #define PT_RESTART()                                                        \
     do {                                                                    \
-        Restart();                                                          \
+        this->Restart();                                                    \
         return true;                                                        \
     } while (0)
 
 // Stop and exit from protothread.
 #define PT_EXIT()                                                           \
     do {                                                                    \
-        Stop();                                                             \
+        this->Stop();                                                       \
         return false;                                                       \
     } while (0)
 
 // Yield protothread till next call to its Run().
-#define PT_YIELD()                                                          \
+#define PT_YIELD() PT_YIELD_UNTIL_AT(PT_NEXT_STATE(), true)
+
+// Yield protothread until given condition is true.
+#define PT_YIELD_UNTIL(condition) PT_YIELD_UNTIL_AT(PT_NEXT_STATE(), condition)
+
+// Implementation details follow.
+
+// Number for the next wait point. Passed as a macro argument, so it is
+// expanded (and __COUNTER__ incremented) once and then used both to save
+// the position and as the case label.
+#if defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__) || defined(__IAR_SYSTEMS_ICC__)
+#define PT_PLACE_COUNTER __COUNTER__
+#else
+#define PT_PLACE_COUNTER __LINE__
+#endif
+#define PT_NEXT_STATE() (PT_PLACE_COUNTER - ptStateStart)
+
+// Save given wait point as the position; it must fit below LineNumberInvalid.
+#define PT_SET_STATE(state)                                                 \
+    static_assert((state) > 0 &&                                            \
+                  (state) < static_cast<decltype(this->_ptLine)>(-1),       \
+                  "Protothread: too many wait points for PT_STATE_TYPE");   \
+    this->_ptLine = static_cast<decltype(this->_ptLine)>(state)
+
+#define PT_WAIT_UNTIL_AT(state, condition)                                  \
     do {                                                                    \
-            ptYielded = false;                                              \
-            _ptLine = __LINE__;                                             \
+            PT_SET_STATE(state);                                            \
         /* fall through */                                                  \
-        case __LINE__:                                                      \
-            if (!ptYielded) {                                               \
-                return true; /* still running, yielded */                   \
+        case (state):                                                       \
+            if (!(condition)) {                                             \
+                return true; /* still running */                            \
             }                                                               \
     } while (0)
 
-// Yield protothread until given condition is true.
-#define PT_YIELD_UNTIL(condition)                                           \
+#define PT_YIELD_UNTIL_AT(state, condition)                                 \
     do {                                                                    \
             ptYielded = false;                                              \
-            _ptLine = __LINE__;                                             \
+            PT_SET_STATE(state);                                            \
         /* fall through */                                                  \
-        case __LINE__:                                                      \
+        case (state):                                                       \
             if (!ptYielded || !(condition)) {                               \
-                return true; /* still running */                            \
+                return true; /* still running, yielded */                   \
             }                                                               \
     } while (0)
 
@@ -0,0 +1,193 @@
+// MpmcChannel: settle() from producer threads racing with parking receivers and with cancel() of
+// destroyed receivers — a settle that finds the lock taken must be run by the holder, never lost
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <sys/time.h>
+
+#include "coro_channel.h"
+#include "coro_scheduler.h"
+#include "check.h"
+
+namespace {
+
+using Policy = ucoro::AtomicPolicy;
+using Channel = ucoro::MpmcChannel<int, 8>;
+using Task = ucoro::Task<void, Policy>;
+
+Task receiver(Channel& ch, std::atomic<long>& sum, std::atomic<int>& count, int n) {
+    for (int i = 0; i < n; ++i) {
+        const int v = co_await ch.receive();
+        sum.fetch_add(v, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void send_all(Channel& ch, int first, int n) {
+    for (int v = first; v < first + n; ++v) {
+        while (!ch.try_send(v)) {
+            (std::this_thread::yield)();
+        }
+    }
+}
+
+// producers only ever try_send(); every hand-off to a parked receiver runs in some settle()
+void producers_and_parked_receivers() {
+    constexpr int producer_count = 4;
+    constexpr int per_producer = 20000;
+    constexpr int receiver_count = 8;
+    constexpr int total = producer_count * per_producer;
+
+    Channel ch;
+    std::atomic<long> sum{0};
+    std::atomic<int> count{0};
+
+    ucoro::Scheduler<Policy> sched;
+    std::vector<Task> tasks;
+    for (int i = 0; i < receiver_count; ++i) {
+        tasks.push_back(receiver(ch, sum, count, total / receiver_count));
+    }
+    for (auto& t : tasks) {
+        sched.spawn(t);
+    }
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producer_count; ++p) {
+        producers.emplace_back(send_all, std::ref(ch), 1 + p * per_producer, per_producer);
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (sched.active() && std::chrono::steady_clock::now() < deadline) {
+        if (sched.run_once() == 0) {
+            (std::this_thread::yield)();
+        }
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    CHECK(sched.active() == 0);
+    CHECK(count.load() == total);
+    CHECK(sum.load() == static_cast<long>(total) * (total + 1) / 2);
+    CHECK(ch.size() == 0);
+}
+
+// a try_send() from inside settle() (a wake hook runs while the lock is held) only leaves a request;
+// the holder delivers it before it lets go
+Channel* hook_channel = nullptr;
+
+void send_from_hook(void*) noexcept {
+    int v = 2;
+    if (hook_channel != nullptr && hook_channel->try_send(v)) {
+        hook_channel = nullptr;
+    }
+}
+
+void send_inside_settle() {
+    Channel ch;
+    std::atomic<long> sum{0};
+    std::atomic<int> count{0};
+
+    ucoro::Scheduler<Policy> sched;
+    auto first = receiver(ch, sum, count, 1);
+    auto second = receiver(ch, sum, count, 1);
+    sched.spawn(first);
+    sched.spawn(second);
+    sched.run_once();
+
+    hook_channel = &ch;
+    sched.set_wake_hook(ucoro::Waker{&send_from_hook, nullptr});
+    CHECK(ch.try_send(1));      // wakes `first`, whose hook sends 2 for `second`
+    CHECK(hook_channel == nullptr);
+    CHECK(ch.size() == 0);
+
+    while (sched.run_once() != 0) {
+    }
+    CHECK(first.done() && second.done());
+    CHECK(sum.load() == 3);
+}
+
+// SIGALRM handler: one try_send() per armed round, at any point of the main loop —
+// including inside cancel() holding the waiter lock
+std::atomic<Channel*> signal_channel{nullptr};
+std::atomic<int> signal_sends{0};
+
+void on_alarm(int) {
+    Channel* ch = signal_channel.load(std::memory_order_relaxed);
+    int v = 1;
+    if (ch != nullptr && ch->try_send(v)) {
+        signal_channel.store(nullptr, std::memory_order_relaxed);
+        signal_sends.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void arm_timer(long usec) {
+    itimerval timer{};
+    timer.it_interval.tv_usec = usec;
+    timer.it_value.tv_usec = usec;
+    setitimer(ITIMER_REAL, &timer, nullptr);
+}
+
+// two receivers stay parked; the older one is destroyed (cancel()) and replaced over and over.
+// A value the handler pushed must never sit in the ring while a receiver is parked
+void cancel_under_signal() {
+    struct sigaction sa{};
+    sa.sa_handler = on_alarm;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &sa, nullptr);
+
+    constexpr int rounds = 400;
+    int stranded = 0;
+
+    arm_timer(50);
+    for (int r = 0; r < rounds; ++r) {
+        Channel ch;
+        std::atomic<long> sum{0};
+        std::atomic<int> count{0};
+
+        ucoro::Scheduler<Policy> sched;
+        Task parked[2] = {receiver(ch, sum, count, 1), receiver(ch, sum, count, 1)};
+        sched.spawn(parked[0]);
+        sched.spawn(parked[1]);
+        sched.run_once();
+
+        const int before = signal_sends.load();
+        signal_channel.store(&ch);
+        for (int oldest = 0; signal_sends.load() == before; oldest ^= 1) {
+            parked[oldest] = Task{};
+            // size() is two loads: a handler that ran in between (push + hand-off) makes it look non-zero
+            const int sends = signal_sends.load();
+            const bool pending = ch.size() != 0;
+            stranded += pending && signal_sends.load() == sends ? 1 : 0;
+            parked[oldest] = receiver(ch, sum, count, 1);
+            sched.spawn(parked[oldest]);
+            while (sched.run_once() != 0) {
+            }
+        }
+        signal_channel.store(nullptr);
+    }
+    arm_timer(0);
+    signal(SIGALRM, SIG_IGN);
+
+    CHECK(stranded == 0);
+}
+
+} // namespace
+
+int main() {
+    producers_and_parked_receivers();
+    send_inside_settle();
+    cancel_under_signal();
+
+    if (failures != 0) {
+        std::printf("channel_settle_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    std::printf("channel_settle_test: ok\n");
+    return 0;
+}
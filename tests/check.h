@@ -0,0 +1,17 @@
+#ifndef UCORO_TESTS_CHECK_H
+#define UCORO_TESTS_CHECK_H
+
+// CHECK() of the standalone test programs: a failed condition is printed and counted, the test goes on
+#include <cstdio>
+
+inline int failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                      \
+        }                                                                    \
+    } while (0)
+
+#endif // UCORO_TESTS_CHECK_H
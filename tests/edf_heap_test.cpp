@@ -0,0 +1,234 @@
+// EdfScheduler: pairing-heap order (meld / merge_pairs), destroying queued tasks (remove() rebuild), deadlines
+// across the tick_t wrap, miss counting, and deadline awaitables in a task of another scheduler
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "coro_edf.h"
+#include "coro_priority.h"
+#include "check.h"
+
+namespace {
+
+using Policy = ucoro::PlainPolicy;
+using Task = ucoro::Task<void, Policy>;
+using Wheel = ucoro::TimerWheel<>;
+using Edf = ucoro::EdfScheduler<Policy, Wheel>;
+
+struct Pick {
+    int id;
+    ucoro::tick_t deadline;     // deadline the activation was picked with; 0 for background tasks
+};
+
+bool not_before(ucoro::tick_t later, ucoro::tick_t earlier) {
+    return static_cast<std::int32_t>(later - earlier) >= 0;
+}
+
+// `rounds` activations, each ready again at once with its deadline moved on by `step`
+Task periodic(std::vector<Pick>& picks, int id, ucoro::tick_t first, ucoro::tick_t step, int rounds) {
+    ucoro::tick_t deadline = first;
+    for (int i = 0; i < rounds; ++i) {
+        picks.push_back({id, deadline});
+        deadline += step;
+        co_await ucoro::set_deadline(deadline);
+        co_yield_now();
+    }
+}
+
+Task background(std::vector<Pick>& picks, int id, int rounds) {
+    for (int i = 0; i < rounds; ++i) {
+        picks.push_back({id, 0});
+        co_yield_now();
+    }
+}
+
+// every pick is the earliest ready deadline: with all tasks ready all the time the sequence never goes back.
+// Background tasks only run after the last deadline task, FIFO among themselves
+void heap_order(ucoro::tick_t base, bool crosses_wrap) {
+    constexpr int task_count = 50;
+    constexpr int rounds = 20;
+    constexpr int background_count = 3;
+
+    std::mt19937 rng(base);
+    std::uniform_int_distribution<ucoro::tick_t> first(0, 1000);
+    std::uniform_int_distribution<ucoro::tick_t> step(1, 50);
+
+    std::vector<Pick> picks;
+    std::vector<Task> tasks;
+    std::vector<ucoro::tick_t> firsts;
+    for (int i = 0; i < background_count; ++i) {
+        tasks.push_back(background(picks, task_count + i, rounds));
+    }
+    for (int i = 0; i < task_count; ++i) {
+        firsts.push_back(base + first(rng));
+        tasks.push_back(periodic(picks, i, firsts.back(), step(rng), rounds));
+    }
+
+    Wheel wheel;
+    Edf sched(wheel);
+    for (int i = 0; i < background_count; ++i) {
+        CHECK(sched.spawn(tasks[i]));
+    }
+    for (int i = 0; i < task_count; ++i) {
+        CHECK(sched.spawn(tasks[background_count + i], firsts[i]));
+    }
+    while (sched.active() != 0) {
+        CHECK(sched.run_next());
+    }
+
+    CHECK(picks.size() == static_cast<std::size_t>((task_count + background_count) * rounds));
+
+    const std::size_t timed = static_cast<std::size_t>(task_count * rounds);
+    bool wrapped = false;
+    for (std::size_t i = 1; i < timed; ++i) {
+        CHECK(picks[i].id < task_count);
+        CHECK(not_before(picks[i].deadline, picks[i - 1].deadline));
+        wrapped = wrapped || picks[i].deadline < picks[i - 1].deadline;
+    }
+    CHECK(wrapped == crosses_wrap);
+
+    for (std::size_t i = timed; i < picks.size(); ++i) {
+        CHECK(picks[i].id == task_count + static_cast<int>((i - timed) % background_count));
+    }
+}
+
+// destroying queued deadline tasks takes them out of the heap; the rest keeps its order
+void remove_queued() {
+    constexpr int task_count = 30;
+    constexpr int rounds = 4;
+
+    std::vector<Pick> picks;
+    std::vector<Task> tasks;
+    for (int i = 0; i < task_count; ++i) {
+        // deadlines interleave, so the heap is reshaped by every pop
+        tasks.push_back(periodic(picks, i, static_cast<ucoro::tick_t>((i * 7) % task_count), 13, rounds));
+    }
+
+    Wheel wheel;
+    Edf sched(wheel);
+    for (int i = 0; i < task_count; ++i) {
+        CHECK(sched.spawn(tasks[i], static_cast<ucoro::tick_t>((i * 7) % task_count)));
+    }
+    for (int i = 0; i < 10; ++i) {
+        CHECK(sched.run_next());
+    }
+
+    std::vector<bool> removed(task_count, false);
+    int removed_count = 0;
+    for (int i = 0; i < task_count; i += 3) {
+        tasks[i] = Task{};
+        removed[i] = true;
+        ++removed_count;
+    }
+    CHECK(sched.active() == static_cast<std::size_t>(task_count - removed_count));
+    CHECK(sched.ready_count() == sched.active());
+
+    const std::size_t before = picks.size();
+    while (sched.active() != 0) {
+        CHECK(sched.run_next());
+    }
+    CHECK(sched.ready_count() == 0);
+
+    for (std::size_t i = before; i < picks.size(); ++i) {
+        CHECK(!removed[picks[i].id]);
+        if (i > before) {
+            CHECK(not_before(picks[i].deadline, picks[i - 1].deadline));
+        }
+    }
+    for (int i = 0; i < task_count; ++i) {
+        CHECK(removed[i] || tasks[i].done());
+    }
+}
+
+// release every `period` ticks with a deadline `budget` after it; the activation ends when the task sleeps again
+Task periodic_job(Wheel& wheel, ucoro::tick_t period, ucoro::tick_t budget, int rounds) {
+    ucoro::tick_t release = wheel.now();
+    for (int i = 0; i < rounds; ++i) {
+        co_await ucoro::set_deadline(release + budget);
+        co_await ucoro::sleep_until(wheel, release);
+        release += period;
+    }
+}
+
+// every third activation is run after its deadline; `start` may put the run across the tick_t wrap
+void deadline_misses(ucoro::tick_t start) {
+    constexpr ucoro::tick_t period = 10;
+    constexpr ucoro::tick_t budget = 5;
+    constexpr int rounds = 10;
+
+    Wheel wheel;
+    wheel.advance(start / 2);   // an empty wheel jumps; two steps reach any start
+    wheel.advance(start);
+
+    Edf sched(wheel);
+    auto job = periodic_job(wheel, period, budget, rounds);
+    CHECK(sched.spawn(job));
+    CHECK(sched.run_next());    // picked without a deadline: not an activation
+    CHECK(sched.activations() == 0);
+
+    for (int k = 1; k < rounds; ++k) {
+        const ucoro::tick_t release = start + static_cast<ucoro::tick_t>(k) * period;
+        wheel.advance(release);
+        if (k % 3 == 0) {
+            wheel.advance(release + budget + 1);
+        }
+        CHECK(sched.run_next());
+    }
+
+    CHECK(job.done());
+    CHECK(sched.activations() == rounds - 1);
+    CHECK(sched.deadline_misses() == 3);
+
+    sched.reset_counters();
+    CHECK(sched.activations() == 0 && sched.deadline_misses() == 0);
+}
+
+Task prioritized(std::vector<int>& order, int id) {
+    co_await ucoro::set_deadline(12345);
+    order.push_back(id);
+    co_yield_now();
+    co_await ucoro::clear_deadline();
+    order.push_back(id);
+}
+
+// outside an EdfScheduler the deadline awaitables leave sched_key (the priority level) alone
+void deadline_elsewhere() {
+    std::vector<int> order;
+    ucoro::PriorityScheduler<Policy, 4> sched;
+    auto low = prioritized(order, 0);
+    auto high = prioritized(order, 3);
+    CHECK(sched.spawn(low, 0));
+    CHECK(sched.spawn(high, 3));
+    while (sched.active() != 0) {
+        CHECK(sched.run_next());
+    }
+    CHECK((order == std::vector<int>{3, 3, 0, 0}));
+
+    // not attached at all
+    std::vector<int> alone;
+    auto t = prioritized(alone, 7);
+    t.resume();
+    CHECK(t.handle().promise().sched_key == 0);
+    CHECK(t.handle().promise().sched_flags == 0);
+    t.resume();
+    CHECK(t.done() && alone.size() == 2);
+}
+
+} // namespace
+
+int main() {
+    heap_order(0, false);
+    heap_order(~ucoro::tick_t(0) - 500, true);
+    remove_queued();
+    deadline_misses(0);
+    deadline_misses(~ucoro::tick_t(0) - 42);
+    deadline_elsewhere();
+
+    if (failures != 0) {
+        std::printf("edf_heap_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    std::printf("edf_heap_test: ok\n");
+    return 0;
+}
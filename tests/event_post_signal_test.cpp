@@ -0,0 +1,118 @@
+// EventController::post() from a SIGALRM handler (setitimer, ~20 kHz) while the main loop keeps
+// dispatching: every post must eventually wake its waiter, none may be lost
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+
+#include <sys/time.h>
+
+#include "coro_event.h"
+#include "coro_scheduler.h"
+#include "check.h"
+
+namespace {
+
+enum class StressEvent { A, B, C, D, COUNT };
+
+constexpr unsigned event_count = static_cast<unsigned>(StressEvent::COUNT);
+
+BasicEventController<StressEvent> controller;
+
+// written by the handler only; incremented before post() so a dispatched bit implies the count
+std::atomic<unsigned> posts[event_count];
+std::atomic<unsigned> next_event{0};
+
+// read by the waiters in the main context
+unsigned seen[event_count];
+unsigned wakes[event_count];
+bool went_back = false;
+
+static_assert(std::atomic<unsigned>::is_always_lock_free, "signal handler needs lock-free counters");
+
+template<StressEvent E>
+void post_one() noexcept {
+    posts[static_cast<unsigned>(E)].fetch_add(1, std::memory_order_relaxed);
+    controller.post<E>();
+}
+
+void on_alarm(int) {
+    switch (next_event.fetch_add(1, std::memory_order_relaxed) % event_count) {
+        case 0: post_one<StressEvent::A>(); break;
+        case 1: post_one<StressEvent::B>(); break;
+        case 2: post_one<StressEvent::C>(); break;
+        default: post_one<StressEvent::D>(); break;
+    }
+}
+
+template<StressEvent E>
+ucoro::Task<void, ucoro::PlainPolicy> waiter() {
+    constexpr unsigned i = static_cast<unsigned>(E);
+    for (;;) {
+        co_await controller.wait<E>();
+        const unsigned now = posts[i].load(std::memory_order_relaxed);
+        went_back = went_back || now < seen[i];
+        seen[i] = now;
+        ++wakes[i];
+    }
+}
+
+void arm_timer(long usec) {
+    itimerval timer{};
+    timer.it_interval.tv_usec = usec;
+    timer.it_value.tv_usec = usec;
+    setitimer(ITIMER_REAL, &timer, nullptr);
+}
+
+} // namespace
+
+int main() {
+    struct sigaction sa{};
+    sa.sa_handler = on_alarm;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &sa, nullptr);
+
+    ucoro::Scheduler<ucoro::PlainPolicy> sched;
+    auto a = waiter<StressEvent::A>();
+    auto b = waiter<StressEvent::B>();
+    auto c = waiter<StressEvent::C>();
+    auto d = waiter<StressEvent::D>();
+    sched.spawn(a);
+    sched.spawn(b);
+    sched.spawn(c);
+    sched.spawn(d);
+    sched.run_once();
+
+    arm_timer(50);
+    const auto stop = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (std::chrono::steady_clock::now() < stop) {
+        controller.dispatch_posted();
+        sched.run_once();
+    }
+    arm_timer(0);
+    signal(SIGALRM, SIG_IGN);
+
+    // posts that arrived after the last pass
+    controller.dispatch_posted();
+    sched.run_once();
+
+    unsigned total = 0;
+    for (unsigned i = 0; i < event_count; ++i) {
+        const unsigned posted = posts[i].load(std::memory_order_relaxed);
+        total += posted;
+        CHECK(posted > 0);
+        CHECK(wakes[i] > 0);
+        CHECK(seen[i] == posted);
+        CHECK(!controller.has_posted());
+    }
+    CHECK(!went_back);
+    CHECK(sched.idle());
+
+    if (failures != 0) {
+        std::printf("event_post_signal_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    std::printf("event_post_signal_test: ok (%u posts)\n", total);
+    return 0;
+}
@@ -0,0 +1,163 @@
+// WorkStealingExecutor: two executors side by side, destroying queued tasks, destroying the executor first
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "coro_executor.h"
+#include "check.h"
+
+namespace {
+
+using Task = ucoro::Task<void, ucoro::AtomicPolicy>;
+using Executor = ucoro::WorkStealingExecutor<>;
+
+// parks the task until the stored Waker fires
+struct Park {
+    std::atomic<ucoro::Waker*>& slot;
+    ucoro::Waker& waker;
+
+    bool await_ready() const noexcept { return false; }
+
+    template<class Promise>
+    void await_suspend(std::coroutine_handle<Promise> h) noexcept {
+        h.promise().block();
+        waker = ucoro::Waker::of(h.promise());
+        slot.store(&waker, std::memory_order_release);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct Parked {
+    std::atomic<ucoro::Waker*> slot{nullptr};
+    ucoro::Waker waker{};
+    std::atomic<int> resumes{0};
+
+    Park park() noexcept { return Park{slot, waker}; }
+
+    // spin until the task parked itself, then wake it
+    void wake() noexcept {
+        ucoro::Waker* w = nullptr;
+        while ((w = slot.exchange(nullptr, std::memory_order_acq_rel)) == nullptr) {
+            (std::this_thread::yield)();     // yield() is a macro
+        }
+        (*w)();
+    }
+
+    bool wait_parked() const noexcept {
+        const auto stop = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (slot.load(std::memory_order_acquire) == nullptr) {
+            if (std::chrono::steady_clock::now() > stop) {
+                return false;
+            }
+            (std::this_thread::yield)();     // yield() is a macro
+        }
+        return true;
+    }
+};
+
+Task park_once(Parked& p) {
+    co_await p.park();
+    p.resumes.fetch_add(1, std::memory_order_relaxed);
+}
+
+Task wake_other(Parked& other) {
+    other.wake();
+    co_return;
+}
+
+bool settle(const Executor& ex, std::size_t expected) {
+    const auto stop = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (ex.active() != expected) {
+        if (std::chrono::steady_clock::now() > stop) {
+            return false;
+        }
+        (std::this_thread::yield)();     // yield() is a macro
+    }
+    return true;
+}
+
+// a task of executor B woken from a worker of executor A must run (and finish) on B
+void two_executors() {
+    Executor a(2);
+    Executor b(2);
+
+    for (int round = 0; round < 200; ++round) {
+        Parked target;
+        Task t = park_once(target);
+        b.spawn(t);
+        CHECK(target.wait_parked());
+
+        Task waker = wake_other(target);
+        a.spawn(waker);
+
+        CHECK(settle(a, 0));
+        CHECK(settle(b, 0));
+        CHECK(t.done());
+    }
+}
+
+std::atomic<bool> hold{false};
+
+Task busy() {
+    while (hold.load(std::memory_order_acquire)) {
+        (std::this_thread::yield)();     // yield() is a macro
+    }
+    co_return;
+}
+
+// destroying a task that sits in the queue: the worker drops it instead of resuming a dead frame
+void cancel_queued() {
+    Executor ex(1);
+    Parked target;
+    {
+        Task t = park_once(target);
+        ex.spawn(t);
+        CHECK(target.wait_parked());
+
+        hold.store(true, std::memory_order_release);
+        Task blocker = busy();
+        ex.spawn(blocker);
+
+        target.wake();          // queued behind the busy task
+        std::thread release([] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            hold.store(false, std::memory_order_release);
+        });
+        t = Task{};             // waits until the worker dropped it
+        release.join();
+        ex.wait();
+    }
+    CHECK(target.resumes.load() == 0);
+    CHECK(ex.active() == 0);
+}
+
+// executor destroyed first: the parked task is detached, waking and destroying it stays safe
+void executor_first() {
+    Parked target;
+    Task t = park_once(target);
+    {
+        Executor ex(2);
+        ex.spawn(t);
+        CHECK(target.wait_parked());
+    }
+    target.wake();
+    CHECK(!t.done());
+    CHECK(target.resumes.load() == 0);
+}
+
+} // namespace
+
+int main() {
+    two_executors();
+    cancel_queued();
+    executor_first();
+
+    if (failures != 0) {
+        std::printf("executor_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    std::printf("executor_test: ok\n");
+    return 0;
+}
@@ -0,0 +1,74 @@
+// StatsRegistry with InstrumentedPolicy tasks whose first resume happens on WorkStealingExecutor workers
+#include <cstdio>
+#include <vector>
+
+#include "coro_executor.h"
+#include "check.h"
+
+namespace {
+
+using Clock = ucoro::SteadyStatsClock;
+using Policy = ucoro::InstrumentedPolicy<Clock, ucoro::AtomicPolicy>;
+using Registry = ucoro::StatsRegistry<Clock>;
+
+constexpr std::size_t task_count = 4000;
+constexpr std::uint32_t task_steps = 4;
+
+ucoro::Task<void, Policy> stepper() {
+    for (std::uint32_t i = 1; i < task_steps; ++i) {
+        co_yield_now();
+    }
+}
+
+void many_workers() {
+    std::vector<ucoro::Task<void, Policy>> tasks;
+    tasks.reserve(task_count);
+    for (std::size_t i = 0; i < task_count; ++i) {
+        tasks.push_back(stepper());
+    }
+    CHECK(Registry::count() == 0);
+
+    {
+        ucoro::WorkStealingExecutor<Policy> ex(4);
+        for (auto& t : tasks) {
+            ex.spawn(t);
+        }
+        ex.wait();
+    }
+
+    CHECK(Registry::count() == task_count);
+    std::size_t resumes = 0;
+    Registry::for_each([&resumes](const auto& s) { resumes += s.resumes; });
+    CHECK(resumes == task_count * task_steps);
+
+    // frames destroyed on this thread while a second batch registers on the workers
+    std::vector<ucoro::Task<void, Policy>> second;
+    for (std::size_t i = 0; i < task_count; ++i) {
+        second.push_back(stepper());
+    }
+    {
+        ucoro::WorkStealingExecutor<Policy> ex(4);
+        for (auto& t : second) {
+            ex.spawn(t);
+        }
+        tasks.clear();
+        ex.wait();
+    }
+    CHECK(Registry::count() == task_count);
+
+    second.clear();
+    CHECK(Registry::count() == 0);
+}
+
+} // namespace
+
+int main() {
+    many_workers();
+
+    if (failures != 0) {
+        std::printf("stats_executor_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    std::printf("stats_executor_test: ok\n");
+    return 0;
+}
@@ -0,0 +1,116 @@
+// TimerWheel: expiry order and next_expiry() as a lower bound with timers in several levels
+#include "coro_timer.h"
+#include "check.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+using Wheel = ucoro::TimerWheel<4, 6>;
+
+struct Probe : ucoro::TimerNode {
+    Wheel* wheel = nullptr;
+    ucoro::tick_t fired_at = 0;
+    bool fired = false;
+
+    static void on_fire(ucoro::TimerNode& node) noexcept {
+        Probe& self = static_cast<Probe&>(node);
+        self.fired = true;
+        self.fired_at = self.wheel->now();
+    }
+
+    void arm(Wheel& w, ucoro::tick_t expires) noexcept {
+        wheel = &w;
+        fired = false;
+        fire = &Probe::on_fire;
+        w.schedule(*this, expires);
+    }
+};
+
+// a level-1 timer due before the first occupied level-0 slot
+void level1_before_level0() {
+    Wheel wheel;
+    Probe far_timer, near_timer;
+
+    far_timer.arm(wheel, 64);       // delta 64 -> level 1
+    wheel.advance(30);
+    near_timer.arm(wheel, 93);      // delta 63 -> level 0
+
+    ucoro::tick_t next = 0;
+    CHECK(wheel.next_expiry(next));
+    CHECK(next == 64);
+
+    wheel.advance(63);
+    CHECK(!far_timer.fired && !near_timer.fired);
+    wheel.advance(64);
+    CHECK(far_timer.fired && far_timer.fired_at == 64);
+
+    CHECK(wheel.next_expiry(next));
+    CHECK(next == 93);
+    wheel.advance(93);
+    CHECK(near_timer.fired && near_timer.fired_at == 93);
+    CHECK(!wheel.next_expiry(next));
+}
+
+// random mix of short and long timers: next_expiry() never overshoots the earliest pending timer,
+// and jumping to it fires that timer on time
+void random_mix() {
+    constexpr int count = 64;
+    Wheel wheel;
+    Probe probes[count];
+    std::mt19937 rng(12345);
+
+    wheel.advance(0xFFFFF000u);     // cross the tick_t wrap during the run
+
+    for (int round = 0; round < 2000; ++round) {
+        Probe& p = probes[rng() % count];
+        if (!p.linked()) {
+            const ucoro::tick_t delta = (rng() % 4 == 0) ? 1 + rng() % 20000 : 1 + rng() % 200;
+            p.arm(wheel, wheel.now() + delta);
+        }
+
+        bool any = false;
+        ucoro::tick_t earliest = 0;
+        for (Probe& q : probes) {
+            if (q.linked() && (!any || static_cast<std::int32_t>(q.expires - earliest) < 0)) {
+                earliest = q.expires;
+                any = true;
+            }
+        }
+
+        ucoro::tick_t next = 0;
+        CHECK(wheel.next_expiry(next) == any);
+        if (!any) {
+            continue;
+        }
+        CHECK(static_cast<std::int32_t>(next - wheel.now()) > 0);
+        CHECK(static_cast<std::int32_t>(earliest - next) >= 0);
+
+        // sleep as TicklessLoop does: nothing may fire before `next`
+        CHECK(wheel.advance(next - 1) == 0);
+        wheel.advance(next);
+
+        for (Probe& q : probes) {
+            if (q.fired) {
+                CHECK(q.fired_at == q.expires);
+                q.fired = false;
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    level1_before_level0();
+    random_mix();
+
+    if (failures != 0) {
+        std::printf("timer_wheel_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    std::printf("timer_wheel_test: ok\n");
+    return 0;
+}
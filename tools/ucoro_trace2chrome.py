@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Convert a ucoro binary trace (TraceBuffer::dump()) to Chrome trace-event JSON.
+
+Open the result in chrome://tracing or https://ui.perfetto.dev.
+
+    python3 tools/ucoro_trace2chrome.py trace.bin trace.json [--tick-us 1.0]
+
+Each task gets its own track: Resume..Suspend become duration slices,
+Block/Unblock become instant markers, an Unblock is linked by a flow arrow
+to the next Resume of that task. Event pend/post land on an "events" track;
+an Unblock raised inside pend() carries the event index in its args.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+RESUME, SUSPEND, BLOCK, UNBLOCK, EVENT_PEND, EVENT_POST = range(1, 7)
+
+HEADER = struct.Struct("<4sII")
+RECORD = struct.Struct("<IIHHQ")
+
+
+def read_records(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, version, count = HEADER.unpack_from(data, 0)
+    if magic != b"UCTR" or version != 1:
+        sys.exit("%s: not a ucoro trace (version 1)" % path)
+    offset = HEADER.size
+    for _ in range(count):
+        yield RECORD.unpack_from(data, offset)
+        offset += RECORD.size
+
+
+def convert(records, tick_us):
+    events = []
+    tracks = {}
+    open_slices = {}
+    pending_flow = {}
+    last_time = None
+    ticks = 0
+    last_event = None
+
+    def track(task):
+        if task not in tracks:
+            tid = len(tracks) + 1
+            tracks[task] = tid
+            events.append({"ph": "M", "name": "thread_name", "pid": 1, "tid": tid,
+                           "args": {"name": "task 0x%x" % task}})
+        return tracks[task]
+
+    events.append({"ph": "M", "name": "thread_name", "pid": 1, "tid": 0, "args": {"name": "events"}})
+
+    for seq, time, kind, arg, task in records:
+        # 32-bit timestamps: unwrap with a signed delta, so a record stamped slightly
+        # earlier than its predecessor (another thread / ISR) steps back, not 2^32 ahead
+        if last_time is not None:
+            delta = (time - last_time) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            ticks += delta
+        last_time = time
+        ts = ticks * tick_us
+
+        if kind in (EVENT_PEND, EVENT_POST):
+            name = "pend" if kind == EVENT_PEND else "post"
+            events.append({"ph": "i", "s": "t", "pid": 1, "tid": 0, "ts": ts,
+                           "name": "%s E%d" % (name, arg), "args": {"seq": seq}})
+            last_event = arg if kind == EVENT_PEND else None
+            continue
+
+        tid = track(task)
+        if kind in (RESUME, SUSPEND):
+            last_event = None
+        if kind == RESUME:
+            events.append({"ph": "B", "pid": 1, "tid": tid, "ts": ts, "name": "run"})
+            open_slices[task] = True
+            if task in pending_flow:
+                events.append({"ph": "f", "bp": "e", "pid": 1, "tid": tid, "ts": ts,
+                               "name": "wake", "cat": "wake", "id": pending_flow.pop(task)})
+        elif kind == SUSPEND:
+            if open_slices.pop(task, False):
+                events.append({"ph": "E", "pid": 1, "tid": tid, "ts": ts,
+                               "args": {"finished": bool(arg)}})
+        elif kind == BLOCK:
+            events.append({"ph": "i", "s": "t", "pid": 1, "tid": tid, "ts": ts, "name": "block"})
+        elif kind == UNBLOCK:
+            args = {"seq": seq}
+            if last_event is not None:
+                args["event"] = last_event
+            events.append({"ph": "i", "s": "t", "pid": 1, "tid": tid, "ts": ts, "name": "unblock", "args": args})
+            events.append({"ph": "s", "pid": 1, "tid": tid, "ts": ts, "name": "wake", "cat": "wake", "id": seq})
+            pending_flow[task] = seq
+
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="binary trace written by TraceBuffer::dump()")
+    parser.add_argument("output", help="Chrome trace JSON to write")
+    parser.add_argument("--tick-us", type=float, default=1.0,
+                        help="microseconds per UCORO_TRACE_CLOCK() tick (default 1.0)")
+    args = parser.parse_args()
+
+    with open(args.output, "w") as f:
+        json.dump(convert(read_records(args.input), args.tick_us), f)
+
+
+if __name__ == "__main__":
+    main()